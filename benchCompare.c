@@ -0,0 +1,317 @@
+/*****************************************************************************
+ *
+ * benchCompare.c
+ *
+ * Compares a run stored by benchResults.h against a baseline run of the
+ * same name and exits non-zero on a regression, so a kernel or firmware
+ * release can be qualified against the previous one from a script.
+ *
+ * The raw samples of the two runs are tested with a one-sided Mann-Whitney
+ * U test (normal approximation with tie correction), which makes no
+ * assumption about the shape of the latency distribution, and the
+ * p50/p90/p99/max/mean deltas are printed.  A regression is reported when
+ * the new run is significantly larger at level alpha and its p50 or p99
+ * has grown by more than the threshold percentage.
+ *
+ * 		benchCompare [-f file] [-a alpha] [-t thresholdPct]
+ * 					 [-b baselineIdx] [-n newIdx] name
+ *
+ * Record indices count the records of that name in file order, negative
+ * indices count from the newest, the defaults compare the newest run (-1)
+ * against the one before it (-2).
+ *
+ * exit status: 0 no regression, 1 regression, 2 usage or input error
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <math.h>
+#include "benchResults.h"
+
+#define DEF_ALPHA				0.01
+#define DEF_THRESHOLD_PCT		5.0
+
+typedef struct {
+	long stamp;
+	char kernel[128];
+	char config[256];
+	uint64_t* samples;
+	uint32_t count;
+} run_t;
+
+typedef struct {
+	uint64_t value;
+	int fromNew;
+} ranked_t;
+
+static int compareRanked(const void* a, const void* b)
+{
+	uint64_t x = ((const ranked_t*)a)->value;
+	uint64_t y = ((const ranked_t*)b)->value;
+	return (x > y) - (x < y);
+}
+
+// returns -1 when the samples cannot be stored, run keeps what it had
+static int parseSamples(run_t* run, const char* list)
+{
+	uint32_t cap = 1024;
+	uint64_t* grown;
+	char* end;
+	free(run->samples);
+	run->count = 0;
+	run->samples = malloc(cap * sizeof(uint64_t));
+	if (run->samples == NULL) {
+		return -1;
+	}
+	for (;;) {
+		uint64_t v = strtoull(list, &end, 10);
+		if (end == list) {
+			break;
+		}
+		if (run->count == cap) {
+			grown = realloc(run->samples, cap * 2 * sizeof(uint64_t));
+			if (grown == NULL) {
+				return -1;
+			}
+			run->samples = grown;
+			cap *= 2;
+		}
+		run->samples[run->count++] = v;
+		list = end;
+	}
+	return 0;
+}
+
+static void freeRuns(run_t* runs, int numRuns)
+{
+	int i;
+	for (i = 0; i < numRuns; ++i) {
+		free(runs[i].samples);
+	}
+	free(runs);
+}
+
+// read every record with the given name, returns the number of runs
+static int loadRuns(const char* path, const char* name, run_t** runsOut)
+{
+	run_t* runs = NULL;
+	run_t* grown;
+	run_t* cur = NULL;
+	char* line = NULL;
+	size_t len = 0;
+	int numRuns = 0;
+	size_t nameLen = strlen(name);
+	FILE* f = fopen(path, "r");
+
+	if (f == NULL) {
+		printf("cannot open results file %s\n", path);
+		return -1;
+	}
+	while (getline(&line, &len, f) != -1) {
+		line[strcspn(line, "\n")] = '\0';
+		if (strncmp(line, "record ", 7) == 0) {
+			cur = NULL;
+			if (strncmp(line + 7, name, nameLen) == 0 &&
+					line[7 + nameLen] == ' ') {
+				grown = realloc(runs, (numRuns + 1) * sizeof(run_t));
+				if (grown == NULL) {
+					break;
+				}
+				runs = grown;
+				cur = &runs[numRuns++];
+				memset(cur, 0, sizeof(*cur));
+				cur->stamp = atol(line + 8 + nameLen);
+			}
+		}
+		else if (cur == NULL) {
+			continue;
+		}
+		else if (strncmp(line, "kernel ", 7) == 0) {
+			snprintf(cur->kernel, sizeof(cur->kernel), "%s", line + 7);
+		}
+		else if (strncmp(line, "config ", 7) == 0) {
+			snprintf(cur->config, sizeof(cur->config), "%s", line + 7);
+		}
+		else if (strncmp(line, "samples", 7) == 0) {
+			if (parseSamples(cur, line + 7) != 0) {
+				break;
+			}
+		}
+	}
+	free(line);
+	if (ferror(f) || !feof(f)) {
+		printf("could not load the runs from %s\n", path);
+		fclose(f);
+		freeRuns(runs, numRuns);
+		return -1;
+	}
+	fclose(f);
+	*runsOut = runs;
+	return numRuns;
+}
+
+// one-sided p value for the new samples being stochastically larger
+static double mannWhitney(const run_t* base, const run_t* next, double* zOut)
+{
+	uint32_t n1 = next->count, n2 = base->count, n = n1 + n2;
+	ranked_t* all = malloc(n * sizeof(ranked_t));
+	double rankSumNew = 0.0, tieSum = 0.0;
+	double u, mu, sigma, z;
+	uint32_t i, j, k;
+
+	if (all == NULL) {
+		return 1.0;
+	}
+	for (i = 0; i < n2; ++i) {
+		all[i].value = base->samples[i];
+		all[i].fromNew = 0;
+	}
+	for (i = 0; i < n1; ++i) {
+		all[n2 + i].value = next->samples[i];
+		all[n2 + i].fromNew = 1;
+	}
+	qsort(all, n, sizeof(ranked_t), compareRanked);
+
+	// ties share the average of the ranks they span
+	for (i = 0; i < n; i = j) {
+		double t, rank;
+		for (j = i + 1; j < n && all[j].value == all[i].value; ++j) {
+		}
+		t = j - i;
+		rank = (i + 1 + j) / 2.0;
+		for (k = i; k < j; ++k) {
+			if (all[k].fromNew) {
+				rankSumNew += rank;
+			}
+		}
+		tieSum += t * t * t - t;
+	}
+	free(all);
+
+	u = rankSumNew - (double)n1 * (n1 + 1) / 2.0;
+	mu = (double)n1 * n2 / 2.0;
+	sigma = sqrt((double)n1 * n2 / 12.0 *
+			((n + 1) - tieSum / ((double)n * (n - 1))));
+	if (sigma == 0.0) {
+		*zOut = 0.0;
+		return 1.0;
+	}
+	z = (u - mu) / sigma;
+	*zOut = z;
+	return 0.5 * erfc(z / sqrt(2.0));
+}
+
+static uint64_t percentile(const uint64_t* sorted, uint32_t count, double pct)
+{
+	uint32_t idx = (uint32_t)(count * pct / 100.0);
+	return sorted[(idx >= count) ? count - 1 : idx];
+}
+
+static double deltaPct(double base, double next)
+{
+	return (base == 0.0) ? 0.0 : 100.0 * (next - base) / base;
+}
+
+static int selectRun(int idx, int numRuns)
+{
+	if (idx < 0) {
+		idx += numRuns;
+	}
+	return (idx >= 0 && idx < numRuns) ? idx : -1;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* path = benchResultPath();
+	double alpha = DEF_ALPHA;
+	double threshold = DEF_THRESHOLD_PCT;
+	int baseIdx = -2, newIdx = -1;
+	static const double pcts[] = { 50.0, 90.0, 99.0, 100.0 };
+	static const char* pctNames[] = { "p50", "p90", "p99", "max" };
+	double pctDelta[4];
+	run_t* runs = NULL;
+	run_t* base;
+	run_t* next;
+	double p, z, baseMean = 0.0, newMean = 0.0;
+	int numRuns, regression;
+	uint32_t i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "f:a:t:b:n:h")) != -1) {
+		switch (opt) {
+		case 'f': path = optarg; break;
+		case 'a': alpha = atof(optarg); break;
+		case 't': threshold = atof(optarg); break;
+		case 'b': baseIdx = atoi(optarg); break;
+		case 'n': newIdx = atoi(optarg); break;
+		default:
+			optind = argc + 1;
+			break;
+		}
+	}
+	if (optind != argc - 1) {
+		printf("usage: %s [-f file] [-a alpha] [-t thresholdPct] "
+				"[-b baselineIdx] [-n newIdx] name\n", argv[0]);
+		return 2;
+	}
+
+	numRuns = loadRuns(path, argv[optind], &runs);
+	if (numRuns < 0) {
+		return 2;
+	}
+	baseIdx = selectRun(baseIdx, numRuns);
+	newIdx = selectRun(newIdx, numRuns);
+	if (baseIdx < 0 || newIdx < 0) {
+		printf("%s has %d runs of %s, need a baseline and a new run\n", path,
+				numRuns, argv[optind]);
+		return 2;
+	}
+	base = &runs[baseIdx];
+	next = &runs[newIdx];
+	if (base->count < 2 || next->count < 2) {
+		printf("runs need at least two samples each\n");
+		return 2;
+	}
+
+	p = mannWhitney(base, next, &z);
+	qsort(base->samples, base->count, sizeof(uint64_t), benchCompareU64);
+	qsort(next->samples, next->count, sizeof(uint64_t), benchCompareU64);
+	for (i = 0; i < base->count; ++i) {
+		baseMean += base->samples[i];
+	}
+	for (i = 0; i < next->count; ++i) {
+		newMean += next->samples[i];
+	}
+	baseMean /= base->count;
+	newMean /= next->count;
+
+	printf("\n%s: baseline run %d (%s, %u samples) vs run %d (%s, %u samples)"
+			"\n\n", argv[optind], baseIdx, base->kernel, base->count, newIdx,
+			next->kernel, next->count);
+	printf("%-6s %14s %14s %9s\n", "", "baseline", "new", "delta");
+	for (i = 0; i < 4; ++i) {
+		uint64_t b = percentile(base->samples, base->count, pcts[i]);
+		uint64_t n = percentile(next->samples, next->count, pcts[i]);
+		pctDelta[i] = deltaPct(b, n);
+		printf("%-6s %14llu %14llu %8.1f%%\n", pctNames[i],
+				(unsigned long long)b, (unsigned long long)n, pctDelta[i]);
+	}
+	printf("%-6s %14.1f %14.1f %8.1f%%\n", "mean", baseMean, newMean,
+			deltaPct(baseMean, newMean));
+	printf("\nMann-Whitney z = %.3f, one-sided p = %.3g (alpha %.3g)\n",
+			z, p, alpha);
+
+	regression = (p < alpha) &&
+			(pctDelta[0] > threshold || pctDelta[2] > threshold);
+	printf("%s\n", regression ? "REGRESSION" : "no regression");
+
+	freeRuns(runs, numRuns);
+	return regression ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+/*****************************************************************************
+ *
+ * benchResults.h
+ *
+ * Structured results store for the benchmark and latency programs.
+ *
+ * benchResultWrite appends one record per run to a local text results file
+ * (BENCH_RESULTS_FILE, or the file named by the BENCH_RESULTS environment
+ * variable).  A record holds the host, kernel and cpu model it ran on, a
+ * free form configuration string, a distribution summary, the log-linear
+ * histogram of phaseBudget.h and the raw samples, up to
+ * BENCH_MAX_SAMPLES of them:
+ *
+ * 		record <name> <unix time>
+ * 		host <nodename>
+ * 		kernel <release> <machine>
+ * 		cpu <model>
+ * 		config <free form text>
+ * 		summary <count> <min> <p50> <p90> <p99> <max> <mean>
+ * 		hist <bin>:<count> ...
+ * 		samples <v> <v> ...
+ * 		end
+ *
+ * benchCompare reads the file back and tests a run against a baseline.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef BENCH_RESULTS_H
+#define BENCH_RESULTS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/utsname.h>
+#include "phaseBudget.h"
+
+#define BENCH_RESULTS_FILE		"benchResults.txt"
+#define BENCH_MAX_SAMPLES		100000		// raw samples kept per record
+
+static inline const char* benchResultPath(void)
+{
+	const char* path = getenv("BENCH_RESULTS");
+	return (path != NULL && path[0] != '\0') ? path : BENCH_RESULTS_FILE;
+}
+
+// cpu model from /proc/cpuinfo, x86 reports "model name", ARM kernels
+// report "Hardware" or "Processor"
+static inline void benchCpuModel(char* model, size_t len)
+{
+	char line[256];
+	FILE* f = fopen("/proc/cpuinfo", "r");
+	snprintf(model, len, "unknown");
+	if (f == NULL) {
+		return;
+	}
+	while (fgets(line, sizeof(line), f) != NULL) {
+		char* colon = strchr(line, ':');
+		if (colon == NULL) {
+			continue;
+		}
+		if (strncmp(line, "model name", 10) == 0 ||
+				strncmp(line, "Hardware", 8) == 0 ||
+				strncmp(line, "Processor", 9) == 0) {
+			colon++;
+			while (*colon == ' ' || *colon == '\t') {
+				colon++;
+			}
+			colon[strcspn(colon, "\n")] = '\0';
+			snprintf(model, len, "%s", colon);
+			if (strncmp(line, "Processor", 9) != 0) {
+				break;
+			}
+		}
+	}
+	fclose(f);
+}
+
+static inline int benchCompareU64(const void* a, const void* b)
+{
+	uint64_t x = *(const uint64_t*)a;
+	uint64_t y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+// append a record of count samples to the results file, the samples are
+// left unmodified, returns -1 on failure
+static inline int benchResultWrite(const char* name, const char* config,
+		const uint64_t* samples, uint32_t count)
+{
+	struct utsname uts;
+	phaseHist_t* hist;
+	uint64_t* sorted;
+	uint64_t sum = 0;
+	char model[128];
+	uint32_t i;
+	FILE* f;
+
+	if (count == 0) {
+		return -1;
+	}
+	sorted = malloc(count * sizeof(uint64_t));
+	hist = calloc(1, sizeof(phaseHist_t));
+	f = fopen(benchResultPath(), "a");
+	if (sorted == NULL || hist == NULL || f == NULL) {
+		printf("could not write results to %s\n", benchResultPath());
+		free(sorted);
+		free(hist);
+		if (f != NULL) {
+			fclose(f);
+		}
+		return -1;
+	}
+	memcpy(sorted, samples, count * sizeof(uint64_t));
+	qsort(sorted, count, sizeof(uint64_t), benchCompareU64);
+	for (i = 0; i < count; ++i) {
+		sum += sorted[i];
+		phaseHistAdd(hist, sorted[i]);
+	}
+	uname(&uts);
+	benchCpuModel(model, sizeof(model));
+
+	fprintf(f, "record %s %ld\n", name, (long)time(NULL));
+	fprintf(f, "host %s\n", uts.nodename);
+	fprintf(f, "kernel %s %s\n", uts.release, uts.machine);
+	fprintf(f, "cpu %s\n", model);
+	fprintf(f, "config %s\n", (config != NULL) ? config : "");
+	fprintf(f, "summary %u %llu %llu %llu %llu %llu %llu\n", count,
+			(unsigned long long)sorted[0],
+			(unsigned long long)sorted[count / 2],
+			(unsigned long long)sorted[(uint64_t)count * 90 / 100],
+			(unsigned long long)sorted[(uint64_t)count * 99 / 100],
+			(unsigned long long)sorted[count - 1],
+			(unsigned long long)(sum / count));
+	fprintf(f, "hist");
+	for (i = 0; i < PHASE_HIST_BINS; ++i) {
+		if (hist->bins[i] != 0) {
+			fprintf(f, " %u:%u", i, hist->bins[i]);
+		}
+	}
+	fprintf(f, "\nsamples");
+	for (i = 0; i < count && i < BENCH_MAX_SAMPLES; ++i) {
+		fprintf(f, " %llu", (unsigned long long)samples[i]);
+	}
+	fprintf(f, "\nend\n");
+
+	fclose(f);
+	free(sorted);
+	free(hist);
+	return 0;
+}
+
+#endif // BENCH_RESULTS_H
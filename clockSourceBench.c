@@ -0,0 +1,313 @@
+/*****************************************************************************
+ *
+ * clockSourceBench.c
+ *
+ * Measures the clock sources available for interval timing on the current
+ * kernel:
+ *
+ * 		1.	call overhead of clock_gettime for each clock id, and of the
+ * 			same call forced through the system call, a clock whose cost
+ * 			matches the system call is not being served by the vDSO.
+ * 		2.	resolution, both as reported by clock_getres and as the
+ * 			smallest non-zero step observed between consecutive reads.
+ * 		3.	monotonicity violations, consecutive reads on one cpu that go
+ * 			backwards.
+ * 		4.	cross-cpu consistency, a reading taken on one cpu is handed to
+ * 			a thread on another cpu which checks its own reading is not
+ * 			earlier, reporting the count and worst size of violations.
+ * 			Skipped for the cpu time clocks, which are not wall time.
+ *
+ * Raw cycle counters (TSC on x86, the generic timer virtual count on
+ * aarch64) are measured alongside.  The ARMv7 cycle counter is only
+ * readable from user space when the kernel enables it, so it is skipped.
+ *
+ * The call cost of every clock is timed in COST_CHUNKS equal chunks and
+ * appended to the benchResults.h results file as clockCost.<clock> and
+ * clockCost.<clock>.syscall records, one sample per chunk.
+ *
+ * 		clockSourceBench [iterations] [cpuA] [cpuB]
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/syscall.h>
+#include <sys/auxv.h>
+#include "benchResults.h"
+
+#define DEF_ITERATIONS			1000000
+#define XCPU_ROUNDS				100000		// cross cpu hand-offs
+#define COST_CHUNKS				64			// timed chunks, one sample each
+#define CLOCK_CYCLES			-1			// pseudo id for the cycle counter
+#define CLOCK_GETTIMEOFDAY		-2			// pseudo id for gettimeofday
+
+typedef struct {
+	clockid_t id;
+	const char* name;
+} clockDesc_t;
+
+static const clockDesc_t clocks[] = {
+	{ CLOCK_REALTIME, "CLOCK_REALTIME" },
+	{ CLOCK_REALTIME_COARSE, "CLOCK_REALTIME_COARSE" },
+	{ CLOCK_MONOTONIC, "CLOCK_MONOTONIC" },
+	{ CLOCK_MONOTONIC_COARSE, "CLOCK_MONOTONIC_COARSE" },
+	{ CLOCK_MONOTONIC_RAW, "CLOCK_MONOTONIC_RAW" },
+	{ CLOCK_BOOTTIME, "CLOCK_BOOTTIME" },
+	{ CLOCK_PROCESS_CPUTIME_ID, "CLOCK_PROCESS_CPUTIME_ID" },
+	{ CLOCK_THREAD_CPUTIME_ID, "CLOCK_THREAD_CPUTIME_ID" },
+	{ CLOCK_GETTIMEOFDAY, "gettimeofday" },
+#if defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+	{ CLOCK_CYCLES, "cycle counter" },
+#endif
+};
+#define NUM_CLOCKS (sizeof(clocks) / sizeof(clocks[0]))
+
+int iterations = DEF_ITERATIONS;
+
+static inline uint64_t readCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	uint32_t lo, hi;
+	__asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+	return ((uint64_t)hi << 32) | lo;
+#elif defined(__aarch64__)
+	uint64_t val;
+	__asm__ __volatile__("isb; mrs %0, cntvct_el0" : "=r"(val));
+	return val;
+#else
+	return 0;
+#endif
+}
+
+// read a clock in its native units, nsec for everything but the counter
+static inline uint64_t readClock(clockid_t id, int viaSyscall)
+{
+	struct timespec ts;
+	struct timeval tv;
+	if (id == CLOCK_CYCLES) {
+		return readCycles();
+	}
+	if (id == CLOCK_GETTIMEOFDAY) {
+		if (viaSyscall) {
+			syscall(SYS_gettimeofday, &tv, NULL);
+		}
+		else {
+			gettimeofday(&tv, NULL);
+		}
+		return (uint64_t)tv.tv_sec * 1000000000ULL + tv.tv_usec * 1000ULL;
+	}
+	if (viaSyscall) {
+		syscall(SYS_clock_gettime, id, &ts);
+	}
+	else {
+		clock_gettime(id, &ts);
+	}
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t monoNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// average nsec per call, the chunk times are recorded as name
+static double callCost(clockid_t id, int viaSyscall, int iters,
+		const char* name)
+{
+	uint64_t samples[COST_CHUNKS];
+	uint64_t total = 0;
+	uint64_t sink = 0;
+	uint64_t start;
+	char recName[64], config[64];
+	int chunk = (iters < COST_CHUNKS) ? 1 : iters / COST_CHUNKS;
+	int c, i;
+	for (c = 0; c < COST_CHUNKS; ++c) {
+		start = monoNs();
+		for (i = 0; i < chunk; ++i) {
+			sink += readClock(id, viaSyscall);
+		}
+		samples[c] = monoNs() - start;
+		total += samples[c];
+	}
+	__asm__ __volatile__("" : : "r"(sink));
+	// record names are single words, "cycle counter" becomes cycle_counter
+	snprintf(recName, sizeof(recName), "clockCost.%s%s", name,
+			viaSyscall ? ".syscall" : "");
+	for (i = 0; recName[i] != '\0'; ++i) {
+		if (recName[i] == ' ') {
+			recName[i] = '_';
+		}
+	}
+	snprintf(config, sizeof(config), "chunkCalls=%d", chunk);
+	benchResultWrite(recName, config, samples, COST_CHUNKS);
+	return (double)total / ((uint64_t)chunk * COST_CHUNKS);
+}
+
+// smallest observed step and number of backwards steps
+static void stepStats(clockid_t id, uint64_t* minStep, uint64_t* backwards)
+{
+	uint64_t prev = readClock(id, 0);
+	uint64_t cur;
+	int i;
+	*minStep = UINT64_MAX;
+	*backwards = 0;
+	for (i = 0; i < iterations; ++i) {
+		cur = readClock(id, 0);
+		if (cur < prev) {
+			(*backwards)++;
+		}
+		else if (cur > prev && cur - prev < *minStep) {
+			*minStep = cur - prev;
+		}
+		prev = cur;
+	}
+}
+
+// cross cpu hand-off state, a reading travels from the ping thread to the
+// pong thread through a sequence counter
+typedef struct {
+	clockid_t id;
+	int cpu;
+	volatile uint64_t stamp;
+	volatile uint32_t seq;
+	uint64_t violations;
+	uint64_t worstNs;
+} xcpu_t;
+
+static void pinSelf(int cpu)
+{
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(cpu, &cpuSet);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+}
+
+static void* pingTask(void* arg)
+{
+	xcpu_t* x = (xcpu_t*)arg;
+	uint32_t i;
+	pinSelf(x->cpu);
+	for (i = 1; i <= XCPU_ROUNDS; ++i) {
+		// wait for the pong side to consume the previous reading
+		while (__atomic_load_n(&x->seq, __ATOMIC_ACQUIRE) != 2 * i - 2) {
+		}
+		x->stamp = readClock(x->id, 0);
+		__atomic_store_n(&x->seq, 2 * i - 1, __ATOMIC_RELEASE);
+	}
+	return NULL;
+}
+
+static void pongSide(xcpu_t* x, int cpu)
+{
+	uint64_t mine;
+	uint32_t i;
+	pinSelf(cpu);
+	for (i = 1; i <= XCPU_ROUNDS; ++i) {
+		while (__atomic_load_n(&x->seq, __ATOMIC_ACQUIRE) != 2 * i - 1) {
+		}
+		mine = readClock(x->id, 0);
+		if (mine < x->stamp) {
+			x->violations++;
+			if (x->stamp - mine > x->worstNs) {
+				x->worstNs = x->stamp - mine;
+			}
+		}
+		__atomic_store_n(&x->seq, 2 * i, __ATOMIC_RELEASE);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int cpuA = 0;
+	int cpuB = 1;
+	int haveTwoCpus;
+	cpu_set_t mainCpus;
+	unsigned c;
+
+	if (argc > 1) {
+		iterations = atoi(argv[1]);
+	}
+	if (argc > 3) {
+		cpuA = atoi(argv[2]);
+		cpuB = atoi(argv[3]);
+	}
+	if (iterations <= 0) {
+		printf("usage: %s [iterations] [cpuA] [cpuB]\n", argv[0]);
+		return 1;
+	}
+	haveTwoCpus = sysconf(_SC_NPROCESSORS_ONLN) > 1;
+	// the pong side pins main, restored after every hand-off
+	pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mainCpus);
+
+	printf("\nvDSO %s mapped into this process\n",
+			getauxval(AT_SYSINFO_EHDR) ? "is" : "is not");
+	printf("cross cpu check between cpu %d and cpu %d%s\n\n", cpuA, cpuB,
+			haveTwoCpus ? "" : " skipped, only one cpu online");
+	printf("%-26s %8s %8s %6s %10s %10s %8s %10s %10s\n", "clock", "ns/call",
+			"syscall", "vDSO", "getres ns", "min step", "back", "xcpu viol",
+			"xcpu ns");
+
+	for (c = 0; c < NUM_CLOCKS; ++c) {
+		const clockDesc_t* cd = &clocks[c];
+		struct timespec res = { 0, 0 };
+		double cost, sysCost = 0.0;
+		uint64_t minStep, backwards;
+		xcpu_t x = { 0 };
+		const char* vdso = "-";
+		char viol[24] = "-", worst[24] = "-";
+		// a cpu time clock counts cpu time, not wall time, and the thread
+		// clock read by two threads is two different clocks
+		int cpuTime = (cd->id == CLOCK_PROCESS_CPUTIME_ID ||
+				cd->id == CLOCK_THREAD_CPUTIME_ID);
+
+		cost = callCost(cd->id, 0, iterations, cd->name);
+		if (cd->id != CLOCK_CYCLES) {
+			sysCost = callCost(cd->id, 1, iterations / 10 + 1, cd->name);
+			// a vDSO read is several times cheaper than the trap
+			vdso = (cost < sysCost * 0.5) ? "yes" : "no";
+			if (cd->id != CLOCK_GETTIMEOFDAY) {
+				clock_getres(cd->id, &res);
+			}
+			else {
+				res.tv_nsec = 1000;
+			}
+		}
+		stepStats(cd->id, &minStep, &backwards);
+
+		if (haveTwoCpus && !cpuTime) {
+			pthread_t pingVar;
+			x.id = cd->id;
+			x.cpu = cpuA;
+			pthread_create(&pingVar, NULL, pingTask, &x);
+			pongSide(&x, cpuB);
+			pthread_join(pingVar, NULL);
+			pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+					&mainCpus);
+			snprintf(viol, sizeof(viol), "%llu",
+					(unsigned long long)x.violations);
+			snprintf(worst, sizeof(worst), "%llu",
+					(unsigned long long)x.worstNs);
+		}
+
+		printf("%-26s %8.1f %8.1f %6s %10ld %10llu %8llu %10s %10s\n",
+				cd->name, cost, sysCost, vdso,
+				(long)(res.tv_sec * 1000000000L + res.tv_nsec),
+				(unsigned long long)(minStep == UINT64_MAX ? 0 : minStep),
+				(unsigned long long)backwards, viol, worst);
+	}
+	printf("\ncycle counter values are in counter ticks, not nsec, the cross "
+			"cpu check is\nskipped for the cpu time clocks\n");
+
+	return 0;
+}
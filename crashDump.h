@@ -0,0 +1,331 @@
+/*****************************************************************************
+ *
+ * crashDump.h
+ *
+ * Fatal signal handler that writes the in-memory measurement state to a
+ * file before the process dies, so the latency data leading up to a crash
+ * is not lost with it.
+ *
+ * Regions are registered once at start up, a histogram, a phase budget, an
+ * array of 32-bit words (measurement arrays, register shadows) or raw
+ * bytes (trace rings).  The dump file is opened up front and on SIGSEGV,
+ * SIGBUS, SIGILL, SIGFPE or SIGABRT the handler formats every region as
+ * text into a static buffer and writes it with write(2).  Only async-signal
+ * safe calls are made, no stdio and no allocation.  The handler runs on a
+ * per-thread alternate stack set up by crashDumpThreadInit, so a stack
+ * overflow can still be dumped.  Afterwards the default action is restored
+ * and the signal raised again, so the exit status and any core file are
+ * unchanged.
+ *
+ * The file is opened for append, a dump is added after those of earlier
+ * runs.  When several threads fault at once only the first one dumps.
+ *
+ * 		crashDumpInit("p9Crash.txt");
+ * 		crashDumpThreadInit();		at the top of every other thread
+ * 		crashDumpAddBudget("mapBudget", &mapBudget);
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef CRASH_DUMP_H
+#define CRASH_DUMP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <errno.h>
+#include "phaseBudget.h"
+
+#define CD_MAX_REGIONS			64
+#define CD_BUF_SIZE				4096
+#define CD_ALT_STACK_SIZE		65536
+
+enum { CD_HIST, CD_BUDGET, CD_WORDS, CD_RAW };
+
+typedef struct {
+	int kind;
+	const char* name;
+	const volatile void* ptr;
+	size_t count;				// words for CD_WORDS, bytes for CD_RAW
+} cdRegion_t;
+
+static cdRegion_t cdRegions[CD_MAX_REGIONS];
+static int cdNumRegions;
+static int cdFd = -1;
+static int cdDumping;
+static char cdBuf[CD_BUF_SIZE];
+static size_t cdLen;
+
+static const int cdSignals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+static const char* cdSignalNames[] = {
+	"SIGSEGV", "SIGBUS", "SIGILL", "SIGFPE", "SIGABRT"
+};
+#define CD_NUM_SIGNALS			(sizeof(cdSignals) / sizeof(cdSignals[0]))
+
+// formatting helpers, all writes go through cdBuf and write(2)
+static inline void cdFlush(void)
+{
+	size_t done = 0;
+	while (done < cdLen) {
+		ssize_t n = write(cdFd, cdBuf + done, cdLen - done);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			break;
+		}
+		done += n;
+	}
+	cdLen = 0;
+}
+
+static inline void cdPutStr(const char* s)
+{
+	while (*s != '\0') {
+		if (cdLen == CD_BUF_SIZE) {
+			cdFlush();
+		}
+		cdBuf[cdLen++] = *s++;
+	}
+}
+
+static inline void cdPutU64(uint64_t v)
+{
+	char tmp[21];
+	int i = sizeof(tmp) - 1;
+	tmp[i] = '\0';
+	do {
+		tmp[--i] = (char)('0' + v % 10);
+		v /= 10;
+	} while (v != 0);
+	cdPutStr(&tmp[i]);
+}
+
+static inline void cdPutHex(uint64_t v, int digits)
+{
+	static const char hex[] = "0123456789abcdef";
+	char tmp[17];
+	int i;
+	for (i = digits - 1; i >= 0; --i) {
+		tmp[i] = hex[v & 0xF];
+		v >>= 4;
+	}
+	tmp[digits] = '\0';
+	cdPutStr(tmp);
+}
+
+static inline void cdPutHist(const phaseHist_t* h)
+{
+	uint32_t b;
+	cdPutStr(" count ");
+	cdPutU64(h->count);
+	cdPutStr(" sumNs ");
+	cdPutU64(h->sumNs);
+	cdPutStr(" maxNs ");
+	cdPutU64(h->maxNs);
+	cdPutStr("\n");
+	// non-zero buckets only, lower bound in nsec and count
+	for (b = 0; b < PHASE_HIST_BINS; ++b) {
+		if (h->bins[b] != 0) {
+			cdPutStr("    ");
+			cdPutU64(phaseHistBinValue(b));
+			cdPutStr(" ");
+			cdPutU64(h->bins[b]);
+			cdPutStr("\n");
+		}
+	}
+}
+
+static inline void cdPutRegion(const cdRegion_t* r)
+{
+	const phaseBudget_t* pb;
+	size_t i;
+	int p;
+
+	cdPutStr("region ");
+	cdPutStr(r->name);
+	switch (r->kind) {
+	case CD_HIST:
+		cdPutStr(" hist");
+		cdPutHist((const phaseHist_t*)r->ptr);
+		break;
+	case CD_BUDGET:
+		pb = (const phaseBudget_t*)r->ptr;
+		cdPutStr(" budget cycle");
+		cdPutHist(&pb->cycle);
+		for (p = 0; p < pb->numPhases; ++p) {
+			cdPutStr("  phase ");
+			cdPutStr(pb->names[p]);
+			cdPutHist(&pb->phase[p]);
+		}
+		break;
+	case CD_WORDS:
+		cdPutStr(" words ");
+		cdPutU64(r->count);
+		for (i = 0; i < r->count; ++i) {
+			if ((i & 7) == 0) {
+				cdPutStr("\n    ");
+				cdPutHex(i, 4);
+				cdPutStr(":");
+			}
+			cdPutStr(" ");
+			cdPutHex(((const volatile uint32_t*)r->ptr)[i], 8);
+		}
+		cdPutStr("\n");
+		break;
+	case CD_RAW:
+		cdPutStr(" bytes ");
+		cdPutU64(r->count);
+		for (i = 0; i < r->count; ++i) {
+			if ((i & 31) == 0) {
+				cdPutStr("\n    ");
+				cdPutHex(i, 6);
+				cdPutStr(": ");
+			}
+			cdPutHex(((const volatile uint8_t*)r->ptr)[i], 2);
+		}
+		cdPutStr("\n");
+		break;
+	}
+}
+
+static inline void cdHandler(int sig, siginfo_t* info, void* context)
+{
+	struct sigaction dfl;
+	struct timespec ts;
+	const char* name = "signal";
+	unsigned s;
+	int r;
+
+	(void)context;
+	// a second faulting thread waits for the first to finish and re-raise
+	if (__atomic_exchange_n(&cdDumping, 1, __ATOMIC_SEQ_CST)) {
+		for (;;) {
+			pause();
+		}
+	}
+	for (s = 0; s < CD_NUM_SIGNALS; ++s) {
+		if (cdSignals[s] == sig) {
+			name = cdSignalNames[s];
+		}
+	}
+	clock_gettime(CLOCK_REALTIME, &ts);
+	cdLen = 0;
+	cdPutStr("\ncrash dump pid ");
+	cdPutU64((uint64_t)getpid());
+	cdPutStr(" ");
+	cdPutStr(name);
+	cdPutStr(" (");
+	cdPutU64((uint64_t)sig);
+	cdPutStr(") code ");
+	cdPutU64((uint64_t)(uint32_t)info->si_code);
+	cdPutStr(" addr 0x");
+	cdPutHex((uint64_t)(uintptr_t)info->si_addr, sizeof(void*) * 2);
+	cdPutStr(" time ");
+	cdPutU64((uint64_t)ts.tv_sec);
+	cdPutStr("\n");
+	for (r = 0; r < cdNumRegions; ++r) {
+		cdPutRegion(&cdRegions[r]);
+	}
+	cdPutStr("end of crash dump\n");
+	cdFlush();
+	fsync(cdFd);
+
+	memset(&dfl, 0, sizeof(dfl));
+	dfl.sa_handler = SIG_DFL;
+	sigemptyset(&dfl.sa_mask);
+	sigaction(sig, &dfl, NULL);
+	// delivered once the handler returns, a fault repeats and is fatal
+	raise(sig);
+}
+
+// give the calling thread an alternate signal stack, it is never freed
+// because the handler may need it until the process exits
+static inline void crashDumpThreadInit(void)
+{
+	stack_t ss;
+	ss.ss_sp = malloc(CD_ALT_STACK_SIZE);
+	ss.ss_size = CD_ALT_STACK_SIZE;
+	ss.ss_flags = 0;
+	if (ss.ss_sp == NULL || sigaltstack(&ss, NULL) == -1) {
+		printf("could not set the crash dump signal stack\n");
+		free(ss.ss_sp);
+	}
+}
+
+// open the dump file and install the handler for the whole process, the
+// calling thread also gets its alternate stack, returns -1 on failure
+static inline int crashDumpInit(const char* path)
+{
+	struct sigaction sa;
+	unsigned s;
+
+	cdFd = open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+	if (cdFd == -1) {
+		printf("cannot open crash dump file %s\n", path);
+		return -1;
+	}
+	crashDumpThreadInit();
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_sigaction = cdHandler;
+	sa.sa_flags = SA_SIGINFO | SA_ONSTACK;
+	// block the other fatal signals while dumping
+	sigemptyset(&sa.sa_mask);
+	for (s = 0; s < CD_NUM_SIGNALS; ++s) {
+		sigaddset(&sa.sa_mask, cdSignals[s]);
+	}
+	for (s = 0; s < CD_NUM_SIGNALS; ++s) {
+		if (sigaction(cdSignals[s], &sa, NULL) == -1) {
+			printf("could not install crash handler for %s\n",
+					cdSignalNames[s]);
+		}
+	}
+	return 0;
+}
+
+static inline void crashDumpAdd(int kind, const char* name,
+		const volatile void* ptr, size_t count)
+{
+	if (cdNumRegions == CD_MAX_REGIONS) {
+		printf("crash dump region %s dropped, table full\n", name);
+		return;
+	}
+	cdRegions[cdNumRegions].kind = kind;
+	cdRegions[cdNumRegions].name = name;
+	cdRegions[cdNumRegions].ptr = ptr;
+	cdRegions[cdNumRegions].count = count;
+	__atomic_store_n(&cdNumRegions, cdNumRegions + 1, __ATOMIC_RELEASE);
+}
+
+// name must outlive the process, a string literal or a static buffer
+static inline void crashDumpAddHist(const char* name, const phaseHist_t* h)
+{
+	crashDumpAdd(CD_HIST, name, h, 0);
+}
+
+static inline void crashDumpAddBudget(const char* name,
+		const phaseBudget_t* pb)
+{
+	crashDumpAdd(CD_BUDGET, name, pb, 0);
+}
+
+static inline void crashDumpAddWords(const char* name,
+		const volatile uint32_t* words, size_t count)
+{
+	crashDumpAdd(CD_WORDS, name, words, count);
+}
+
+static inline void crashDumpAddRaw(const char* name, const volatile void* ptr,
+		size_t bytes)
+{
+	crashDumpAdd(CD_RAW, name, ptr, bytes);
+}
+
+#endif // CRASH_DUMP_H
@@ -0,0 +1,210 @@
+/*****************************************************************************
+ *
+ * flightDecode.c
+ *
+ * Prints the events held by a flightRecorder.h ring, oldest first, for
+ * post-mortem analysis after a crash or watchdog reset.
+ *
+ * 		flightDecode [-n last] -f ringFile		simulation ring file
+ * 		flightDecode [-n last] -m				FPGA on-chip RAM via /dev/mem
+ *
+ * The ring is copied out in one pass before decoding so the board can keep
+ * recording.  Times are CLOCK_MONOTONIC usec as recorded, unwrapped between
+ * consecutive events, with the delta to the previous event.  Sequence gaps
+ * are events that were overwritten or torn by the crash.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "socRegMap.h"
+#include "flightRecorder.h"
+
+// copy the ring out of FPGA on-chip RAM
+static uint32_t* readFpga(size_t* bytes)
+{
+	uint32_t* copy;
+	volatile uint32_t* mem;
+	size_t i;
+	int fd = open("/dev/mem", O_RDONLY | O_SYNC);
+
+	if (fd == -1) {
+		printf("Cannot open device file.\n");
+		return NULL;
+	}
+	mem = (volatile uint32_t*)mmap(NULL, FPGA_FLIGHT_BYTES, PROT_READ,
+			MAP_SHARED, fd, HPS_FPGA_MEM_BASE + FPGA_FLIGHT_OFFSET);
+	close(fd);
+	if (mem == MAP_FAILED) {
+		printf("ERROR: mmap() FPGA failed...\n");
+		return NULL;
+	}
+	copy = malloc(FPGA_FLIGHT_BYTES);
+	if (copy != NULL) {
+		for (i = 0; i < FPGA_FLIGHT_BYTES / sizeof(uint32_t); ++i) {
+			copy[i] = mem[i];
+		}
+		*bytes = FPGA_FLIGHT_BYTES;
+	}
+	munmap((void*)mem, FPGA_FLIGHT_BYTES);
+	return copy;
+}
+
+static uint32_t* readFile(const char* path, size_t* bytes)
+{
+	struct stat st;
+	uint32_t* copy;
+	FILE* f = fopen(path, "rb");
+
+	if (f == NULL || fstat(fileno(f), &st) == -1) {
+		printf("cannot open ring file %s\n", path);
+		if (f != NULL) {
+			fclose(f);
+		}
+		return NULL;
+	}
+	copy = malloc(st.st_size);
+	if (copy != NULL && fread(copy, 1, st.st_size, f) != (size_t)st.st_size) {
+		printf("short read from %s\n", path);
+		free(copy);
+		copy = NULL;
+	}
+	fclose(f);
+	*bytes = st.st_size;
+	return copy;
+}
+
+static void printDetail(uint32_t type, uint32_t arg, uint32_t value)
+{
+	time_t wall = value;
+	char stamp[32];
+
+	switch (type) {
+	case FR_EV_SESSION:
+		strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S",
+				localtime(&wall));
+		printf("pid %u started %s", arg, stamp);
+		break;
+	case FR_EV_CYCLE_START:
+		printf("task %u cycle %u", arg, value);
+		break;
+	case FR_EV_CYCLE_END:
+		printf("task %u exec %u nsec", arg, value);
+		break;
+	case FR_EV_OVERRUN:
+		printf("task %u late %u nsec", arg, value);
+		break;
+	case FR_EV_BUTTON:
+		printf("%s key%u %s", (arg >> 8) ? "FPGA" : "GPIO2", arg & 0xFF,
+				value ? "pressed" : "released");
+		break;
+	case FR_EV_REG_WRITE:
+		printf("offset 0x%06x = 0x%08x", arg, value);
+		break;
+	case FR_EV_FAILOVER:
+		printf("standby pid %u took over %u usec after the last heartbeat",
+				arg, value);
+		break;
+	case FR_EV_THROTTLE:
+		printf("task %u throttled, %u times so far", arg, value);
+		break;
+	default:
+		printf("arg 0x%06x value 0x%08x", arg, value);
+		break;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	const char* path = NULL;
+	int useFpga = 0;
+	uint32_t last = 0;
+	uint32_t* ring;
+	size_t bytes = 0;
+	uint32_t capacity, newest = 0, valid, first, n, prevSeq = 0;
+	uint64_t timeUs = 0;
+	uint32_t prevTime = 0;
+	int havePrev = 0;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "f:mn:h")) != -1) {
+		switch (opt) {
+		case 'f': path = optarg; break;
+		case 'm': useFpga = 1; break;
+		case 'n': last = strtoul(optarg, NULL, 0); break;
+		default:
+			path = NULL;
+			useFpga = 0;
+			optind = argc;
+			break;
+		}
+	}
+	if ((path == NULL) == (useFpga == 0)) {
+		printf("usage: %s [-n last] -f ringFile | -m\n", argv[0]);
+		return 2;
+	}
+
+	ring = useFpga ? readFpga(&bytes) : readFile(path, &bytes);
+	if (ring == NULL) {
+		return 1;
+	}
+	capacity = ring[FR_HDR_CAPACITY];
+	if (bytes < FR_HDR_WORDS * sizeof(uint32_t) ||
+			ring[FR_HDR_MAGIC] != FR_MAGIC ||
+			ring[FR_HDR_LAYOUT] != FR_LAYOUT ||
+			capacity != flightRecCapacity(bytes)) {
+		printf("no flight recorder ring found\n");
+		free(ring);
+		return 1;
+	}
+
+	valid = flightRecScan(ring, capacity, &newest);
+	printf("\n%u of %u events valid, %u sessions, last session started %u "
+			"(CLOCK_REALTIME sec)\n\n", valid, capacity,
+			ring[FR_HDR_SESSIONS], ring[FR_HDR_START_SEC]);
+	if (valid == 0) {
+		free(ring);
+		return 0;
+	}
+
+	n = (last != 0 && last < capacity) ? last : capacity;
+	first = newest - n + 1;
+	printf("%10s %16s %10s  %-10s\n", "seq", "time (usec)", "delta", "event");
+	for (; n > 0; --n, ++first) {
+		const uint32_t* e = (const uint32_t*)flightRecEntry(ring, capacity,
+				first);
+		uint32_t type = e[FR_ENT_TAG] >> 24;
+
+		if (e[FR_ENT_SEQ] != first) {
+			continue;
+		}
+		if (havePrev && first != prevSeq + 1) {
+			printf("%10s %16s %10s  lost %u events\n", "", "", "",
+					first - prevSeq - 1);
+		}
+		// times are 32-bit usec, assume forward progress between events
+		timeUs = havePrev ? timeUs + (uint32_t)(e[FR_ENT_TIME] - prevTime) :
+				e[FR_ENT_TIME];
+		printf("%10u %16llu %10lld  %-10s ", first,
+				(unsigned long long)timeUs,
+				havePrev ? (long long)(uint32_t)(e[FR_ENT_TIME] - prevTime) :
+						0LL,
+				flightRecEventName(type));
+		printDetail(type, e[FR_ENT_TAG] & 0xFFFFFF, e[FR_ENT_VALUE]);
+		printf("\n");
+		prevSeq = first;
+		prevTime = e[FR_ENT_TIME];
+		havePrev = 1;
+	}
+	free(ring);
+	return 0;
+}
@@ -0,0 +1,257 @@
+/*****************************************************************************
+ *
+ * flightRecorder.h
+ *
+ * Black-box ring of the most recent events, kept in memory that outlives the
+ * process so the last moments before a crash or watchdog reset can be read
+ * back afterwards with flightDecode.
+ *
+ * On the board the ring lives in FPGA on-chip RAM at FPGA_FLIGHT_OFFSET,
+ * which keeps its contents across a process restart and a warm reset as
+ * long as the FPGA is not reconfigured.  In simulation it lives in a
+ * MAP_SHARED file, which the page cache keeps when the process dies.
+ *
+ * Layout, all 32-bit words so it can sit in device memory:
+ *
+ * 		header	FR_HDR_WORDS words, magic, layout, capacity, session count,
+ * 				next sequence hint, current session start time
+ * 		events	capacity entries of FR_ENTRY_WORDS words, sequence number,
+ * 				type << 24 | 24-bit argument, value, CLOCK_MONOTONIC usec
+ *
+ * Capacity is a power of two and event n lives in slot n % capacity.  A
+ * writer invalidates the slot's sequence word first and writes the new
+ * sequence last, so an entry torn by a crash is recognised and skipped.
+ * Recording is a clock read, one atomic add and six word stores, cheap
+ * enough to leave enabled in the field.  Attaching to a ring with a valid
+ * header continues after its newest event, so earlier sessions are kept
+ * until they are overwritten.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include "socRegMap.h"
+
+#define FR_MAGIC				0x43524C46	// "FLRC"
+#define FR_LAYOUT				1
+#define FR_HDR_WORDS			16
+#define FR_ENTRY_WORDS			4
+#define FR_SEQ_EMPTY			0xFFFFFFFF
+#define FR_DEF_ENTRIES			4096		// file ring size
+
+// header words
+enum {
+	FR_HDR_MAGIC, FR_HDR_LAYOUT, FR_HDR_CAPACITY, FR_HDR_SESSIONS,
+	FR_HDR_NEXT, FR_HDR_START_US, FR_HDR_START_SEC
+};
+
+// entry words
+enum { FR_ENT_SEQ, FR_ENT_TAG, FR_ENT_VALUE, FR_ENT_TIME };
+
+// event types, the argument and value meaning is given per type
+enum {
+	FR_EV_NONE,
+	FR_EV_SESSION,		// arg pid, value CLOCK_REALTIME seconds
+	FR_EV_CYCLE_START,	// arg task, value cycle count
+	FR_EV_CYCLE_END,	// arg task, value execution time in nsec
+	FR_EV_OVERRUN,		// arg task, value nsec past the deadline
+	FR_EV_BUTTON,		// arg source << 8 | key, value pressed
+	FR_EV_REG_WRITE,	// arg register byte offset, value written
+	FR_EV_USER,			// free for ad hoc markers
+	FR_EV_FAILOVER,		// arg new engine pid, value usec since last beat
+	FR_EV_THROTTLE,		// arg task, value SCHED_DEADLINE throttles so far
+	FR_NUM_EVENTS
+};
+
+static inline const char* flightRecEventName(uint32_t type)
+{
+	static const char* names[FR_NUM_EVENTS] = {
+		"none", "session", "cycleStart", "cycleEnd", "overrun", "button",
+		"regWrite", "user", "failover", "throttle"
+	};
+	return (type < FR_NUM_EVENTS) ? names[type] : "?";
+}
+
+typedef struct {
+	volatile uint32_t* base;	// NULL while the recorder is disabled
+	uint32_t capacity;
+	uint32_t next;				// next sequence number, atomic
+	uint32_t* counter;			// &next unless shared between processes
+	size_t mapBytes;			// non-zero when the recorder owns the mapping
+} flightRec_t;
+
+static inline volatile uint32_t* flightRecEntry(volatile uint32_t* base,
+		uint32_t capacity, uint32_t slot)
+{
+	return base + FR_HDR_WORDS + (slot & (capacity - 1)) * FR_ENTRY_WORDS;
+}
+
+// largest power of two number of entries that fits in bytes
+static inline uint32_t flightRecCapacity(size_t bytes)
+{
+	uint32_t cap = 1;
+	if (bytes < (FR_HDR_WORDS + FR_ENTRY_WORDS) * sizeof(uint32_t)) {
+		return 0;
+	}
+	while ((FR_HDR_WORDS + 2 * cap * FR_ENTRY_WORDS) * sizeof(uint32_t) <=
+			bytes) {
+		cap *= 2;
+	}
+	return cap;
+}
+
+// find the newest valid event, returns the number of valid events and sets
+// *newest to its sequence number, sequence numbers compare modulo 2^32
+static inline uint32_t flightRecScan(volatile const uint32_t* base,
+		uint32_t capacity, uint32_t* newest)
+{
+	uint32_t slot, valid = 0;
+	for (slot = 0; slot < capacity; ++slot) {
+		uint32_t seq = base[FR_HDR_WORDS + slot * FR_ENTRY_WORDS + FR_ENT_SEQ];
+		if (seq == FR_SEQ_EMPTY || (seq & (capacity - 1)) != slot) {
+			continue;
+		}
+		if (valid == 0 || (int32_t)(seq - *newest) > 0) {
+			*newest = seq;
+		}
+		++valid;
+	}
+	return valid;
+}
+
+// RT path, append one event, a no-op while the recorder is disabled
+static inline void flightRecord(flightRec_t* fr, uint32_t type, uint32_t arg,
+		uint32_t value)
+{
+	struct timespec ts;
+	volatile uint32_t* e;
+	uint32_t seq;
+
+	if (fr->base == NULL) {
+		return;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	seq = __atomic_fetch_add(fr->counter, 1, __ATOMIC_RELAXED);
+	e = flightRecEntry(fr->base, fr->capacity, seq);
+	e[FR_ENT_SEQ] = FR_SEQ_EMPTY;
+	SOC_REG_BARRIER();
+	e[FR_ENT_TAG] = (type << 24) | (arg & 0xFFFFFF);
+	e[FR_ENT_VALUE] = value;
+	e[FR_ENT_TIME] = (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL +
+			ts.tv_nsec / 1000);
+	SOC_REG_BARRIER();
+	e[FR_ENT_SEQ] = seq;
+	fr->base[FR_HDR_NEXT] = seq + 1;
+}
+
+// use bytes of already mapped memory for the ring, keeps the events of
+// earlier sessions unless the header does not match or reset is set
+static inline int flightRecAttach(flightRec_t* fr, volatile void* mem,
+		size_t bytes, int reset)
+{
+	volatile uint32_t* base = (volatile uint32_t*)mem;
+	uint32_t capacity = flightRecCapacity(bytes);
+	uint32_t newest = 0, slot;
+	struct timespec mono, real;
+
+	memset(fr, 0, sizeof(*fr));
+	if (capacity == 0) {
+		printf("flight recorder region of %zu bytes is too small\n", bytes);
+		return -1;
+	}
+	if (reset || base[FR_HDR_MAGIC] != FR_MAGIC ||
+			base[FR_HDR_LAYOUT] != FR_LAYOUT ||
+			base[FR_HDR_CAPACITY] != capacity) {
+		for (slot = 0; slot < capacity; ++slot) {
+			flightRecEntry(base, capacity, slot)[FR_ENT_SEQ] = FR_SEQ_EMPTY;
+		}
+		base[FR_HDR_SESSIONS] = 0;
+		base[FR_HDR_LAYOUT] = FR_LAYOUT;
+		base[FR_HDR_CAPACITY] = capacity;
+		SOC_REG_BARRIER();
+		base[FR_HDR_MAGIC] = FR_MAGIC;
+	}
+	else if (flightRecScan(base, capacity, &newest) > 0) {
+		fr->next = newest + 1;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &mono);
+	clock_gettime(CLOCK_REALTIME, &real);
+	base[FR_HDR_SESSIONS] = base[FR_HDR_SESSIONS] + 1;
+	base[FR_HDR_START_US] = (uint32_t)((uint64_t)mono.tv_sec * 1000000ULL +
+			mono.tv_nsec / 1000);
+	base[FR_HDR_START_SEC] = (uint32_t)real.tv_sec;
+	fr->base = base;
+	fr->capacity = capacity;
+	fr->counter = &fr->next;
+	flightRecord(fr, FR_EV_SESSION, (uint32_t)getpid(),
+			(uint32_t)real.tv_sec);
+	return 0;
+}
+
+// map a ring file for simulation, created with the given number of entries
+// when it does not exist yet
+static inline int flightRecOpenFile(flightRec_t* fr, const char* path,
+		uint32_t entries, int reset)
+{
+	size_t bytes = (FR_HDR_WORDS + (size_t)entries * FR_ENTRY_WORDS) *
+			sizeof(uint32_t);
+	void* mem;
+	int fd = open(path, O_RDWR | O_CREAT, 0644);
+
+	memset(fr, 0, sizeof(*fr));
+	if (fd == -1) {
+		printf("cannot open flight recorder file %s\n", path);
+		return -1;
+	}
+	if (ftruncate(fd, bytes) == -1) {
+		printf("cannot size flight recorder file %s\n", path);
+		close(fd);
+		return -1;
+	}
+	mem = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (mem == MAP_FAILED) {
+		printf("cannot map flight recorder file %s\n", path);
+		return -1;
+	}
+	if (flightRecAttach(fr, mem, bytes, reset) != 0) {
+		munmap(mem, bytes);
+		return -1;
+	}
+	fr->mapBytes = bytes;
+	return 0;
+}
+
+// move the sequence counter to memory shared with a forked process, so
+// both processes can record into the same ring
+static inline void flightRecShareCounter(flightRec_t* fr, uint32_t* shared)
+{
+	if (fr->base != NULL) {
+		*shared = __atomic_load_n(fr->counter, __ATOMIC_RELAXED);
+		fr->counter = shared;
+	}
+}
+
+// stop recording, a file ring is flushed and unmapped, FPGA RAM is left
+// mapped for its owner
+static inline void flightRecClose(flightRec_t* fr)
+{
+	if (fr->base != NULL && fr->mapBytes != 0) {
+		msync((void*)fr->base, fr->mapBytes, MS_SYNC);
+		munmap((void*)fr->base, fr->mapBytes);
+	}
+	fr->base = NULL;
+}
+
+#endif // FLIGHT_RECORDER_H
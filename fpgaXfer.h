@@ -0,0 +1,182 @@
+/*****************************************************************************
+ *
+ * fpgaXfer.h
+ *
+ * Block transfers between process memory and mapped device memory such as
+ * the FPGA on-chip RAM.
+ *
+ * The device side of every transfer must be word aligned and a whole number
+ * of words long, misaligned accesses across the HPS-to-FPGA bridge are
+ * either split or fault, so they are rejected up front instead.  Within a
+ * block the widest access the alignment allows is used, 128 bit NEON (or
+ * SSE2 on a host) stores and loads when the device address is 16 byte
+ * aligned, then 64 bit and finally 32 bit for the head and tail.  A single
+ * memory barrier is issued per block rather than per word.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef FPGA_XFER_H
+#define FPGA_XFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "socRegMap.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FPGA_XFER_VEC128		1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define FPGA_XFER_VEC128		1
+#endif
+
+#define FPGA_XFER_ALIGN			4		// minimum device alignment in bytes
+
+// returns non-zero if a transfer of len bytes at the device address dev
+// satisfies the alignment rules
+static inline int fpgaXferAligned(volatile const void* dev, size_t len)
+{
+	return (((uintptr_t)dev | len) & (FPGA_XFER_ALIGN - 1)) == 0;
+}
+
+// copy len bytes from src to the device at dst, returns -1 without touching
+// the device when dst or len is not word aligned
+static inline int fpgaXferToDev(volatile void* dst, const void* src,
+		size_t len)
+{
+	volatile uint8_t* d = (volatile uint8_t*)dst;
+	const uint8_t* s = (const uint8_t*)src;
+	uint32_t w32;
+	uint64_t w64;
+
+	if (!fpgaXferAligned(dst, len)) {
+		return -1;
+	}
+	SOC_REG_BARRIER();
+
+	// head, word stores up to the next 8 or 16 byte boundary
+	while (len >= 4 && ((uintptr_t)d & 7) != 0) {
+		memcpy(&w32, s, 4);
+		*(volatile uint32_t*)d = w32;
+		d += 4; s += 4; len -= 4;
+	}
+	if (len >= 8 && ((uintptr_t)d & 15) != 0) {
+		memcpy(&w64, s, 8);
+		*(volatile uint64_t*)d = w64;
+		d += 8; s += 8; len -= 8;
+	}
+#ifdef FPGA_XFER_VEC128
+	// body, four 128 bit stores per iteration
+	while (len >= 64) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+		uint8x16_t v0 = vld1q_u8(s), v1 = vld1q_u8(s + 16);
+		uint8x16_t v2 = vld1q_u8(s + 32), v3 = vld1q_u8(s + 48);
+		vst1q_u8((uint8_t*)d, v0);
+		vst1q_u8((uint8_t*)d + 16, v1);
+		vst1q_u8((uint8_t*)d + 32, v2);
+		vst1q_u8((uint8_t*)d + 48, v3);
+#else
+		__m128i v0 = _mm_loadu_si128((const __m128i*)s);
+		__m128i v1 = _mm_loadu_si128((const __m128i*)(s + 16));
+		__m128i v2 = _mm_loadu_si128((const __m128i*)(s + 32));
+		__m128i v3 = _mm_loadu_si128((const __m128i*)(s + 48));
+		_mm_store_si128((__m128i*)d, v0);
+		_mm_store_si128((__m128i*)(d + 16), v1);
+		_mm_store_si128((__m128i*)(d + 32), v2);
+		_mm_store_si128((__m128i*)(d + 48), v3);
+#endif
+		d += 64; s += 64; len -= 64;
+	}
+#endif
+	// remaining body, 64 bit stores
+	while (len >= 8) {
+		memcpy(&w64, s, 8);
+		*(volatile uint64_t*)d = w64;
+		d += 8; s += 8; len -= 8;
+	}
+	if (len >= 4) {
+		memcpy(&w32, s, 4);
+		*(volatile uint32_t*)d = w32;
+	}
+	SOC_REG_BARRIER();
+	return 0;
+}
+
+// copy len bytes from the device at src to dst, returns -1 without touching
+// the device when src or len is not word aligned
+static inline int fpgaXferFromDev(void* dst, volatile const void* src,
+		size_t len)
+{
+	uint8_t* d = (uint8_t*)dst;
+	volatile const uint8_t* s = (volatile const uint8_t*)src;
+	uint32_t w32;
+	uint64_t w64;
+
+	if (!fpgaXferAligned(src, len)) {
+		return -1;
+	}
+	SOC_REG_BARRIER();
+
+	while (len >= 4 && ((uintptr_t)s & 7) != 0) {
+		w32 = *(volatile const uint32_t*)s;
+		memcpy(d, &w32, 4);
+		d += 4; s += 4; len -= 4;
+	}
+	if (len >= 8 && ((uintptr_t)s & 15) != 0) {
+		w64 = *(volatile const uint64_t*)s;
+		memcpy(d, &w64, 8);
+		d += 8; s += 8; len -= 8;
+	}
+#ifdef FPGA_XFER_VEC128
+	while (len >= 64) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+		uint8x16_t v0 = vld1q_u8((const uint8_t*)s);
+		uint8x16_t v1 = vld1q_u8((const uint8_t*)s + 16);
+		uint8x16_t v2 = vld1q_u8((const uint8_t*)s + 32);
+		uint8x16_t v3 = vld1q_u8((const uint8_t*)s + 48);
+		vst1q_u8(d, v0); vst1q_u8(d + 16, v1);
+		vst1q_u8(d + 32, v2); vst1q_u8(d + 48, v3);
+#else
+		__m128i v0 = _mm_load_si128((const __m128i*)s);
+		__m128i v1 = _mm_load_si128((const __m128i*)(s + 16));
+		__m128i v2 = _mm_load_si128((const __m128i*)(s + 32));
+		__m128i v3 = _mm_load_si128((const __m128i*)(s + 48));
+		_mm_storeu_si128((__m128i*)d, v0);
+		_mm_storeu_si128((__m128i*)(d + 16), v1);
+		_mm_storeu_si128((__m128i*)(d + 32), v2);
+		_mm_storeu_si128((__m128i*)(d + 48), v3);
+#endif
+		d += 64; s += 64; len -= 64;
+	}
+#endif
+	while (len >= 8) {
+		w64 = *(volatile const uint64_t*)s;
+		memcpy(d, &w64, 8);
+		d += 8; s += 8; len -= 8;
+	}
+	if (len >= 4) {
+		w32 = *(volatile const uint32_t*)s;
+		memcpy(d, &w32, 4);
+	}
+	SOC_REG_BARRIER();
+	return 0;
+}
+
+// copy a block of 32 bit words into an on-chip RAM region starting at word
+// index idx, e.g. fpgaXferWordsToDev(fpgaRamBufPtr(base), 0, modBuff, n)
+static inline int fpgaXferWordsToDev(volatile uint32_t* region, uint32_t idx,
+		const uint32_t* src, uint32_t numWords)
+{
+	return fpgaXferToDev(region + idx, src, (size_t)numWords * 4);
+}
+
+static inline int fpgaXferWordsFromDev(uint32_t* dst,
+		volatile const uint32_t* region, uint32_t idx, uint32_t numWords)
+{
+	return fpgaXferFromDev(dst, region + idx, (size_t)numWords * 4);
+}
+
+#endif // FPGA_XFER_H
@@ -0,0 +1,259 @@
+/*****************************************************************************
+ *
+ * fpgaXferBench.c
+ *
+ * Compares block transfer throughput into and out of the FPGA on-chip RAM
+ * for the naive one word at a time loop used by taskThree and the
+ * width-optimized transfers in fpgaXfer.h.  Each write is checked right
+ * after it with the word at a time read, and the block write starts from a
+ * region overwritten with a different pattern, so a bridge that drops or
+ * splits wide accesses fails the run rather than showing up as a fast
+ * result.  Reads are compared against the data written.
+ *
+ * Each transfer loop is timed in XFER_CHUNKS equal chunks and appended to
+ * the benchResults.h results file as fpgaXfer.<op>.<bytes>, one sample
+ * per chunk.
+ *
+ * 		fpgaXferBench [-n repeats] [-s]
+ *
+ * -s runs against an anonymous mapping instead of /dev/mem so the tool can
+ * be run on a host.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "socRegMap.h"
+#include "fpgaXfer.h"
+#include "benchResults.h"
+
+#define FPGA_MAP_SIZE			(16 * 4096)	// on-chip RAM mapped for the test
+#define MAX_XFER_BYTES			(FPGA_PIO_BUF_WORDS * 4)	// storage buffer only
+#define DEF_REPEATS				1000
+#define XFER_CHUNKS				32			// timed chunks, one sample each
+
+enum { XFER_NAIVE_WR, XFER_BLOCK_WR, XFER_NAIVE_RD, XFER_BLOCK_RD };
+static const char* xferOpNames[] = { "naiveWr", "blockWr", "naiveRd",
+		"blockRd" };
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// the loop taskThree uses today, one barriered word store per element
+static void naiveToDev(volatile uint32_t* dst, const uint32_t* src,
+		uint32_t numWords)
+{
+	uint32_t i;
+	for (i = 0; i < numWords; ++i) {
+		SOC_REG_BARRIER();
+		dst[i] = src[i];
+	}
+}
+
+static void naiveFromDev(uint32_t* dst, volatile const uint32_t* src,
+		uint32_t numWords)
+{
+	uint32_t i;
+	for (i = 0; i < numWords; ++i) {
+		dst[i] = src[i];
+		SOC_REG_BARRIER();
+	}
+}
+
+// read the region back one word at a time and compare it against expect,
+// reports and returns -1 on a mismatch
+static int checkRegion(const char* what, size_t bytes,
+		volatile const uint32_t* region, const uint32_t* expect,
+		uint32_t* check)
+{
+	naiveFromDev(check, region, bytes / 4);
+	if (memcmp(check, expect, bytes) != 0) {
+		printf("ERROR: %s of %zu bytes did not read back\n", what, bytes);
+		return -1;
+	}
+	return 0;
+}
+
+// run op in XFER_CHUNKS chunks of chunkRepeats transfers, records the chunk
+// times and returns the total
+static uint64_t timeXfer(int op, volatile uint32_t* region,
+		const uint32_t* src, uint32_t* check, size_t bytes, int chunkRepeats,
+		const char* config)
+{
+	uint64_t samples[XFER_CHUNKS];
+	uint64_t start, total = 0;
+	uint32_t words = bytes / 4;
+	char name[48];
+	int c, r;
+
+	for (c = 0; c < XFER_CHUNKS; ++c) {
+		start = nowNs();
+		for (r = 0; r < chunkRepeats; ++r) {
+			switch (op) {
+			case XFER_NAIVE_WR:
+				naiveToDev(region, src, words);
+				break;
+			case XFER_BLOCK_WR:
+				fpgaXferWordsToDev(region, 0, src, words);
+				break;
+			case XFER_NAIVE_RD:
+				naiveFromDev(check, region, words);
+				break;
+			default:
+				fpgaXferWordsFromDev(check, region, 0, words);
+				break;
+			}
+		}
+		samples[c] = nowNs() - start;
+		total += samples[c];
+	}
+	snprintf(name, sizeof(name), "fpgaXfer.%s.%zu", xferOpNames[op], bytes);
+	benchResultWrite(name, config, samples, XFER_CHUNKS);
+	return total;
+}
+
+static double mbPerSec(size_t bytes, int repeats, uint64_t ns)
+{
+	return (double)bytes * repeats * 1e3 / (double)ns;
+}
+
+int main(int argc, char* argv[])
+{
+	volatile uint8_t* fpgaMemBaseAddrPtr;
+	volatile uint32_t* region;
+	uint32_t* src;
+	uint32_t* check;
+	uint32_t* clear;
+	int errors = 0;
+	int repeats = DEF_REPEATS;
+	int chunkRepeats;
+	char config[64];
+	int simulate = 0;
+	int fdMem = -1;
+	size_t bytes;
+	int opt;
+	int r;
+
+	while ((opt = getopt(argc, argv, "n:sh")) != -1) {
+		switch (opt) {
+		case 'n': repeats = atoi(optarg); break;
+		case 's': simulate = 1; break;
+		default:
+			printf("usage: %s [-n repeats] [-s]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (repeats <= 0) {
+		return 1;
+	}
+	// the rates are over the transfers actually run
+	chunkRepeats = (repeats < XFER_CHUNKS) ? 1 : repeats / XFER_CHUNKS;
+	repeats = chunkRepeats * XFER_CHUNKS;
+
+	if (simulate) {
+		fpgaMemBaseAddrPtr = (volatile uint8_t*)mmap(NULL, FPGA_MAP_SIZE,
+				PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+	else {
+		fdMem = open("/dev/mem", (O_RDWR | O_SYNC));
+		if (fdMem == -1) {
+			printf("Cannot open device file.\n");
+			return 1;
+		}
+		fpgaMemBaseAddrPtr = (volatile uint8_t*)mmap(NULL, FPGA_MAP_SIZE,
+				PROT_READ | PROT_WRITE, MAP_SHARED, fdMem, HPS_FPGA_MEM_BASE);
+	}
+	if (fpgaMemBaseAddrPtr == MAP_FAILED) {
+		printf("ERROR: mmap() FPGA failed...\n");
+		return 1;
+	}
+	region = fpgaRamBufPtr(fpgaMemBase(fpgaMemBaseAddrPtr));
+	snprintf(config, sizeof(config), "%s chunkRepeats=%d",
+			simulate ? "anon" : "O_SYNC", chunkRepeats);
+
+	src = malloc(MAX_XFER_BYTES);
+	check = malloc(MAX_XFER_BYTES);
+	clear = malloc(MAX_XFER_BYTES);
+	if (src == NULL || check == NULL || clear == NULL) {
+		return 1;
+	}
+	for (r = 0; r < (int)(MAX_XFER_BYTES / 4); ++r) {
+		src[r] = 0x9E3779B9u * (r + 1);
+		clear[r] = ~src[r];
+	}
+
+	// a misaligned device address must be refused
+	if (fpgaXferToDev((volatile uint8_t*)region + 2, src, 16) != -1) {
+		printf("ERROR: misaligned transfer was not rejected\n");
+		++errors;
+	}
+
+	printf("\n   bytes   naive wr MB/s   block wr MB/s   naive rd MB/s"
+			"   block rd MB/s\n");
+	for (bytes = 64; bytes <= MAX_XFER_BYTES; bytes *= 2) {
+		uint32_t words = bytes / 4;
+		uint64_t naiveWr, blockWr, naiveRd, blockRd;
+
+		naiveWr = timeXfer(XFER_NAIVE_WR, region, src, check, bytes,
+				chunkRepeats, config);
+		if (checkRegion("naive write", bytes, region, src, check) != 0) {
+			++errors;
+		}
+
+		// overwrite what the naive loop left so only the block write can
+		// put src back
+		naiveToDev(region, clear, words);
+		blockWr = timeXfer(XFER_BLOCK_WR, region, src, check, bytes,
+				chunkRepeats, config);
+		if (checkRegion("block write", bytes, region, src, check) != 0) {
+			++errors;
+		}
+
+		naiveRd = timeXfer(XFER_NAIVE_RD, region, src, check, bytes,
+				chunkRepeats, config);
+		if (memcmp(check, src, bytes) != 0) {
+			printf("ERROR: naive read of %zu bytes mismatched\n", bytes);
+			++errors;
+		}
+
+		memset(check, 0, bytes);
+		blockRd = timeXfer(XFER_BLOCK_RD, region, src, check, bytes,
+				chunkRepeats, config);
+		if (memcmp(check, src, bytes) != 0) {
+			printf("ERROR: block read of %zu bytes mismatched\n", bytes);
+			++errors;
+		}
+
+		printf("%8zu  %14.1f  %14.1f  %14.1f  %14.1f\n", bytes,
+				mbPerSec(bytes, repeats, naiveWr),
+				mbPerSec(bytes, repeats, blockWr),
+				mbPerSec(bytes, repeats, naiveRd),
+				mbPerSec(bytes, repeats, blockRd));
+	}
+
+	munmap((void*)fpgaMemBaseAddrPtr, FPGA_MAP_SIZE);
+	if (fdMem != -1) {
+		close(fdMem);
+	}
+	free(src);
+	free(check);
+	free(clear);
+	if (errors != 0) {
+		printf("\n%d transfer check(s) failed\n", errors);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,337 @@
+/*****************************************************************************
+ *
+ * gpioBackendBench.c
+ *
+ * Compares the GPIO character device backend (gpioCdev.h) against the
+ * /dev/mem register mapping used by pthrdsThreeThrdsHWMapP9.c.
+ *
+ * Measurements:
+ * 		1.	output toggle rate, one SET_VALUES ioctl per edge for the cdev
+ * 			backend and one register store per edge for the mmap backend.
+ * 		2.	input read rate, one GET_VALUES ioctl versus one register load.
+ * 		3.	edge event latency for the cdev backend, from the moment the
+ * 			edge is triggered to the kernel event timestamp and to the
+ * 			moment the event is read in userspace.
+ *
+ * Edges are triggered either by an output line wired back to the input
+ * line, or, on a host with gpio-sim, by writing the sysfs pull attribute of
+ * the simulated input line (-p option), e.g.
+ *
+ * 		gpioBackendBench -c /dev/gpiochip1 -i 0 -o 1 \
+ * 			-p /sys/devices/platform/gpio-sim.0/gpiochip1/sim_gpio0/pull
+ *
+ * The mmap measurements (-m option) toggle HPS GPIO1 LED3 and read the
+ * GPIO2 EXT register on the board, and need root for /dev/mem.
+ *
+ * Every measurement is also appended to the benchResults.h results file,
+ * the rates as RATE_CHUNKS timed chunks of equal size and the edge
+ * latencies as one sample per edge.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "gpioCdev.h"
+#include "socRegMap.h"
+#include "benchResults.h"
+
+#define PAGE_SIZE				4096		// linux page size
+#define DEF_TOGGLES				100000		// default toggles per backend
+#define DEF_EVENTS				1000		// default edge events measured
+#define EVENT_TIMEOUT_MS		1000		// give up on an edge after 1 sec
+#define RATE_CHUNKS				64			// timed chunks per rate, one sample each
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int compareU64(const void* a, const void* b)
+{
+	uint64_t x = *(const uint64_t*)a;
+	uint64_t y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+// sort the samples in place and print min, p50, p99 and max
+static void printLatency(const char* label, uint64_t* samples, int count)
+{
+	if (count == 0) {
+		printf("%-28s no samples\n", label);
+		return;
+	}
+	qsort(samples, count, sizeof(uint64_t), compareU64);
+	printf("%-28s min %llu  p50 %llu  p99 %llu  max %llu (nsec)\n", label,
+			(unsigned long long)samples[0],
+			(unsigned long long)samples[count / 2],
+			(unsigned long long)samples[(count * 99) / 100],
+			(unsigned long long)samples[count - 1]);
+}
+
+static void printRate(const char* label, int count, uint64_t elapsedNs)
+{
+	printf("%-28s %.0f ops/sec, %.1f nsec/op\n", label,
+			count * 1e9 / (double)elapsedNs, (double)elapsedNs / count);
+}
+
+// operations per chunk when count operations are split into RATE_CHUNKS
+static int chunkOps(int count)
+{
+	return (count < RATE_CHUNKS) ? 1 : count / RATE_CHUNKS;
+}
+
+// record the chunk times of a rate measurement and print the rate
+static void recordRate(const char* label, const char* name,
+		const char* config, uint64_t* samples, int ops)
+{
+	char chunkConfig[160];
+	uint64_t elapsedNs = 0;
+	int c;
+	for (c = 0; c < RATE_CHUNKS; ++c) {
+		elapsedNs += samples[c];
+	}
+	snprintf(chunkConfig, sizeof(chunkConfig), "%s chunkOps=%d", config, ops);
+	benchResultWrite(name, chunkConfig, samples, RATE_CHUNKS);
+	printRate(label, ops * RATE_CHUNKS, elapsedNs);
+}
+
+static void benchCdevToggle(int outFd, int toggles, const char* config)
+{
+	uint64_t samples[RATE_CHUNKS];
+	uint64_t start;
+	int ops = chunkOps(toggles);
+	int c, i;
+	for (c = 0; c < RATE_CHUNKS; ++c) {
+		start = nowNs();
+		for (i = 0; i < ops; ++i) {
+			gpioCdevSet(outFd, 1, i & 1);
+		}
+		samples[c] = nowNs() - start;
+	}
+	recordRate("cdev toggle:", "gpioCdev.toggle", config, samples, ops);
+}
+
+static void benchCdevRead(int inFd, int reads, const char* config)
+{
+	uint64_t samples[RATE_CHUNKS];
+	uint64_t start;
+	uint64_t bits;
+	int ops = chunkOps(reads);
+	int c, i;
+	for (c = 0; c < RATE_CHUNKS; ++c) {
+		start = nowNs();
+		for (i = 0; i < ops; ++i) {
+			gpioCdevGet(inFd, 1, &bits);
+		}
+		samples[c] = nowNs() - start;
+	}
+	recordRate("cdev read:", "gpioCdev.read", config, samples, ops);
+}
+
+// drive one edge on the input line, level is the new input level
+static int triggerEdge(int outFd, int pullFd, int level)
+{
+	if (pullFd != -1) {
+		const char* val = level ? "pull-up" : "pull-down";
+		return (pwrite(pullFd, val, strlen(val), 0) > 0) ? 0 : -1;
+	}
+	return gpioCdevSet(outFd, 1, level);
+}
+
+static void benchCdevEvents(int inFd, int outFd, int pullFd, int events,
+		const char* config)
+{
+	struct gpio_v2_line_event ev;
+	uint64_t* kernLat = calloc(events, sizeof(uint64_t));
+	uint64_t* userLat = calloc(events, sizeof(uint64_t));
+	uint64_t trigger;
+	int count = 0;
+	int i;
+
+	if (kernLat == NULL || userLat == NULL) {
+		printf("cannot allocate latency samples\n");
+		free(kernLat);
+		free(userLat);
+		return;
+	}
+	for (i = 0; i < events; ++i) {
+		trigger = nowNs();
+		if (triggerEdge(outFd, pullFd, !(i & 1)) == -1) {
+			printf("could not trigger edge %d\n", i);
+			break;
+		}
+		if (gpioCdevReadEvent(inFd, &ev, EVENT_TIMEOUT_MS) != 1) {
+			printf("no edge event seen for edge %d, is the input wired?\n", i);
+			break;
+		}
+		userLat[count] = nowNs() - trigger;
+		kernLat[count] = (ev.timestamp_ns > trigger) ?
+				ev.timestamp_ns - trigger : 0;
+		++count;
+	}
+	if (count > 0) {
+		char eventConfig[160];
+		snprintf(eventConfig, sizeof(eventConfig), "%s trigger=%s", config,
+				(pullFd != -1) ? "sim-pull" : "output-line");
+		benchResultWrite("gpioCdev.edgeKernel", eventConfig, kernLat, count);
+		benchResultWrite("gpioCdev.edgeUser", eventConfig, userLat, count);
+	}
+	printLatency("cdev trigger to kernel:", kernLat, count);
+	printLatency("cdev trigger to user:", userLat, count);
+	free(kernLat);
+	free(userLat);
+}
+
+static void benchMmap(int toggles)
+{
+	volatile uint32_t* gpio1BaseAddrPtr;
+	volatile uint32_t* gpio2BaseAddrPtr;
+	gpio1Base_t gpio1Regs;
+	gpio2Base_t gpio2Regs;
+	uint64_t samples[RATE_CHUNKS];
+	uint64_t start;
+	uint32_t sink = 0;
+	int ops = chunkOps(toggles);
+	int fdMem;
+	int c, i;
+
+	fdMem = open("/dev/mem", (O_RDWR | O_SYNC));
+	if (fdMem == -1) {
+		printf("Cannot open device file /dev/mem, skipping mmap backend.\n");
+		return;
+	}
+	gpio1BaseAddrPtr = (volatile uint32_t*)mmap(NULL, PAGE_SIZE,
+			PROT_READ | PROT_WRITE, MAP_SHARED, fdMem, HPS_GPIO1_BASE);
+	gpio2BaseAddrPtr = (volatile uint32_t*)mmap(NULL, PAGE_SIZE,
+			PROT_READ | PROT_WRITE, MAP_SHARED, fdMem, HPS_GPIO2_BASE);
+	if (gpio1BaseAddrPtr == MAP_FAILED || gpio2BaseAddrPtr == MAP_FAILED) {
+		printf("ERROR: mmap() GPIO failed, skipping mmap backend...\n");
+		close(fdMem);
+		return;
+	}
+	gpio1Regs = gpio1Base(gpio1BaseAddrPtr);
+	gpio2Regs = gpio2Base(gpio2BaseAddrPtr);
+
+	gpio1DdrWrite(gpio1Regs, HPS_GPIO1_ALL_ON);
+	for (c = 0; c < RATE_CHUNKS; ++c) {
+		start = nowNs();
+		for (i = 0; i < ops; ++i) {
+			if (i & 1) {
+				gpio1DrSetBits(gpio1Regs, HPS_GPIO1_LED3);
+			}
+			else {
+				gpio1DrClearBits(gpio1Regs, HPS_GPIO1_LED3);
+			}
+		}
+		samples[c] = nowNs() - start;
+	}
+	recordRate("mmap toggle (rmw):", "gpioMmap.toggle", "O_SYNC", samples,
+			ops);
+
+	for (c = 0; c < RATE_CHUNKS; ++c) {
+		start = nowNs();
+		for (i = 0; i < ops; ++i) {
+			sink += gpio2ExtRead(gpio2Regs);
+		}
+		samples[c] = nowNs() - start;
+	}
+	recordRate("mmap read:", "gpioMmap.read", "O_SYNC", samples, ops);
+	(void)sink;
+
+	gpio1DrClearBits(gpio1Regs, HPS_GPIO1_ALL_ON);
+	munmap((void*)gpio1BaseAddrPtr, PAGE_SIZE);
+	munmap((void*)gpio2BaseAddrPtr, PAGE_SIZE);
+	close(fdMem);
+}
+
+static void usage(const char* prog)
+{
+	printf("usage: %s [-c chip] [-i inLine] [-o outLine] [-p simPullPath]\n"
+			"          [-d debounceUs] [-n toggles] [-e events] [-m]\n", prog);
+}
+
+int main(int argc, char* argv[])
+{
+	const char* chipPath = "/dev/gpiochip0";
+	const char* pullPath = NULL;
+	uint32_t inLine = 0;
+	uint32_t outLine = 1;
+	uint32_t debounceUs = 0;
+	int toggles = DEF_TOGGLES;
+	int events = DEF_EVENTS;
+	int runMmap = 0;
+	int inFd, outFd = -1, pullFd = -1;
+	char config[128];
+	int opt;
+
+	while ((opt = getopt(argc, argv, "c:i:o:p:d:n:e:mh")) != -1) {
+		switch (opt) {
+		case 'c': chipPath = optarg; break;
+		case 'i': inLine = strtoul(optarg, NULL, 0); break;
+		case 'o': outLine = strtoul(optarg, NULL, 0); break;
+		case 'p': pullPath = optarg; break;
+		case 'd': debounceUs = strtoul(optarg, NULL, 0); break;
+		case 'n': toggles = atoi(optarg); break;
+		case 'e': events = atoi(optarg); break;
+		case 'm': runMmap = 1; break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	if (toggles <= 0 || events < 0) {
+		usage(argv[0]);
+		return 1;
+	}
+
+	inFd = gpioCdevRequestInputs(chipPath, &inLine, 1, GPIO_CDEV_EDGE_BOTH,
+			debounceUs);
+	if (inFd == -1) {
+		return 1;
+	}
+	if (pullPath != NULL) {
+		pullFd = open(pullPath, O_WRONLY);
+		if (pullFd == -1) {
+			printf("Cannot open %s\n", pullPath);
+		}
+	}
+	// without a simulator pull attribute the output line is the trigger
+	if (pullFd == -1) {
+		outFd = gpioCdevRequestOutputs(chipPath, &outLine, 1);
+	}
+
+	printf("\nGPIO backend comparison, chip %s, in %u, out %u\n\n",
+			chipPath, inLine, outLine);
+	snprintf(config, sizeof(config), "chip=%s in=%u out=%u debounceUs=%u",
+			chipPath, inLine, outLine, debounceUs);
+	if (outFd != -1) {
+		benchCdevToggle(outFd, toggles, config);
+	}
+	benchCdevRead(inFd, toggles, config);
+	if (events > 0 && (outFd != -1 || pullFd != -1)) {
+		benchCdevEvents(inFd, outFd, pullFd, events, config);
+	}
+	if (runMmap) {
+		benchMmap(toggles);
+	}
+
+	if (outFd != -1) {
+		close(outFd);
+	}
+	if (pullFd != -1) {
+		close(pullFd);
+	}
+	close(inFd);
+	return 0;
+}
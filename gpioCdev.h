@@ -0,0 +1,154 @@
+/*****************************************************************************
+ *
+ * gpioCdev.h
+ *
+ * GPIO backend using the Linux GPIO character device v2 uAPI
+ * (/dev/gpiochipN) as an alternative to mapping the HPS GPIO registers
+ * through /dev/mem.
+ *
+ * A line request groups several lines of one chip behind a single file
+ * descriptor, so all of them can be read or written with one ioctl.  Input
+ * requests can enable edge detection with an optional debounce period, and
+ * the resulting events carry a kernel CLOCK_MONOTONIC timestamp taken in
+ * the interrupt handler.
+ *
+ * On hosts without the board the gpio-sim module provides chips to test
+ * against, e.g. configured through configfs under /sys/kernel/config/gpio-sim.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef GPIO_CDEV_H
+#define GPIO_CDEV_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+
+#define GPIO_CDEV_CONSUMER		"pthrdsHWMap"	// label shown by gpioinfo
+
+// edge selections for gpioCdevRequestInputs
+#define GPIO_CDEV_EDGE_NONE		0
+#define GPIO_CDEV_EDGE_RISING	GPIO_V2_LINE_FLAG_EDGE_RISING
+#define GPIO_CDEV_EDGE_FALLING	GPIO_V2_LINE_FLAG_EDGE_FALLING
+#define GPIO_CDEV_EDGE_BOTH		(GPIO_V2_LINE_FLAG_EDGE_RISING | \
+									GPIO_V2_LINE_FLAG_EDGE_FALLING)
+
+// request numLines lines of the chip at chipPath with the given flags, the
+// returned descriptor addresses the lines by their index in offsets, bit 0
+// being offsets[0], returns -1 on failure
+static inline int gpioCdevRequest(const char* chipPath, const uint32_t* offsets,
+		uint32_t numLines, uint64_t flags, uint32_t debounceUs)
+{
+	struct gpio_v2_line_request req;
+	int chipFd;
+	uint32_t i;
+
+	if (numLines == 0 || numLines > GPIO_V2_LINES_MAX) {
+		printf("gpio cdev: invalid line count %u\n", numLines);
+		return -1;
+	}
+	chipFd = open(chipPath, O_RDWR | O_CLOEXEC);
+	if (chipFd == -1) {
+		printf("gpio cdev: cannot open %s: %s\n", chipPath, strerror(errno));
+		return -1;
+	}
+
+	memset(&req, 0, sizeof(req));
+	for (i = 0; i < numLines; ++i) {
+		req.offsets[i] = offsets[i];
+	}
+	strncpy(req.consumer, GPIO_CDEV_CONSUMER, sizeof(req.consumer) - 1);
+	req.num_lines = numLines;
+	req.config.flags = flags;
+	if (debounceUs > 0) {
+		// the debounce attribute applies to every line in the request
+		req.config.num_attrs = 1;
+		req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+		req.config.attrs[0].attr.debounce_period_us = debounceUs;
+		req.config.attrs[0].mask = (numLines == 64) ? ~0ULL :
+				((1ULL << numLines) - 1);
+	}
+
+	if (ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &req) == -1) {
+		printf("gpio cdev: line request on %s failed: %s\n", chipPath,
+				strerror(errno));
+		close(chipFd);
+		return -1;
+	}
+	// the line descriptor stays valid after the chip descriptor is closed
+	close(chipFd);
+	return req.fd;
+}
+
+// request lines as outputs, all driven to initial level low
+static inline int gpioCdevRequestOutputs(const char* chipPath,
+		const uint32_t* offsets, uint32_t numLines)
+{
+	return gpioCdevRequest(chipPath, offsets, numLines,
+			GPIO_V2_LINE_FLAG_OUTPUT, 0);
+}
+
+// request lines as inputs, edge is one of the GPIO_CDEV_EDGE_ values and
+// debounceUs is zero to disable debouncing, edge timestamps are taken from
+// CLOCK_MONOTONIC
+static inline int gpioCdevRequestInputs(const char* chipPath,
+		const uint32_t* offsets, uint32_t numLines, uint64_t edge,
+		uint32_t debounceUs)
+{
+	return gpioCdevRequest(chipPath, offsets, numLines,
+			GPIO_V2_LINE_FLAG_INPUT | edge, debounceUs);
+}
+
+// read the lines selected by mask with one ioctl, returns -1 on failure
+static inline int gpioCdevGet(int lineFd, uint64_t mask, uint64_t* bits)
+{
+	struct gpio_v2_line_values vals;
+	vals.mask = mask;
+	vals.bits = 0;
+	if (ioctl(lineFd, GPIO_V2_LINE_GET_VALUES_IOCTL, &vals) == -1) {
+		return -1;
+	}
+	*bits = vals.bits;
+	return 0;
+}
+
+// write the lines selected by mask with one ioctl, returns -1 on failure
+static inline int gpioCdevSet(int lineFd, uint64_t mask, uint64_t bits)
+{
+	struct gpio_v2_line_values vals;
+	vals.mask = mask;
+	vals.bits = bits;
+	return ioctl(lineFd, GPIO_V2_LINE_SET_VALUES_IOCTL, &vals);
+}
+
+// wait up to timeoutMs for an edge event (-1 waits forever), returns 1 when
+// an event was read, 0 on timeout and -1 on failure
+static inline int gpioCdevReadEvent(int lineFd, struct gpio_v2_line_event* ev,
+		int timeoutMs)
+{
+	struct pollfd pfd;
+	ssize_t len;
+	int rc;
+
+	pfd.fd = lineFd;
+	pfd.events = POLLIN;
+	rc = poll(&pfd, 1, timeoutMs);
+	if (rc <= 0) {
+		return rc;
+	}
+	len = read(lineFd, ev, sizeof(*ev));
+	if (len != (ssize_t)sizeof(*ev)) {
+		return -1;
+	}
+	return 1;
+}
+
+#endif // GPIO_CDEV_H
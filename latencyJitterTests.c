@@ -5,6 +5,10 @@
  * Example of the effects of realtime scheduling policy and memory locking
  * on latency variation or jitter.
  *
+ * The deviation of every wakeup, up to BENCH_MAX_SAMPLES of them, is kept
+ * and appended to the benchResults.h results file as a latencyJitter
+ * record when the test is stopped with enter.
+ *
  * Original code by Shawn Quinn
  * Created Date:  01/05/2015
  *
@@ -18,6 +22,7 @@
 #include <sys/time.h>
 #include <sys/types.h>
 #include <sys/mman.h>
+#include "benchResults.h"
 
 #define WAIT 50     // for a 50 millisecond pause
 const char rtEnable[] = "high";
@@ -31,6 +36,16 @@ int main(void)
 	struct timeval cur_time, last_time;
 	struct sched_param mysched;
 	fd_set inputs, testfds;
+	uint64_t* devNs;            // wakeup deviations in nsec
+	uint32_t numDev = 0;
+	char config[64];
+
+	devNs = malloc(BENCH_MAX_SAMPLES * sizeof(uint64_t));
+	if(devNs == NULL)
+	{
+		puts(" ERROR ALLOCATING THE SAMPLE BUFFER");
+		exit (1);
+	}
 
     if(strncmp(rtEnable, "high", 4) == 0)
     {
@@ -91,11 +106,16 @@ int main(void)
         else
             average = (average + abs (current))/2;
         last_time = cur_time;
+        if(result == 0 && numDev < BENCH_MAX_SAMPLES)
+            devNs[numDev++] = (uint64_t)labs (current) * 1000;
         if(result == 0)
             printf("min %ld, max %ld, avg %ld, current %ld          \r",
                      min, max, average, current);
         last_time = cur_time;
     }
 	printf("\nEnd latency test process, iteration count = %d\n", count);
+	snprintf(config, sizeof(config), "priority=%s waitMs=%d", rtEnable, WAIT);
+	benchResultWrite("latencyJitter", config, devNs, numDev);
+	free(devNs);
 	return 0;
 }
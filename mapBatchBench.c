@@ -0,0 +1,179 @@
+/*****************************************************************************
+ *
+ * mapBatchBench.c
+ *
+ * Compares mapping K frames with K modMapFrame calls, one setup each, to a
+ * single modMapBatch call, for K doubling from 1 up to the maximum given,
+ * which is measured last even when it is not a power of two, and reports
+ * the nsec per frame of both.
+ *
+ * 		mapBatchBench [-k maxK] [-w inWords] [-b bitsPerSym] [-g gain]
+ * 					  [-r rotPeriod] [-n repeats] [-e evictKiB]
+ *
+ * Every frame has its own input and output buffer.  Before each repeat an
+ * eviction buffer is written so both variants start from a cold cache, as
+ * after a long wait in the RT loop, -e 0 keeps the cache warm.  The batch
+ * output is checked against the single frame output.  The per-frame times
+ * of every repeat are stored as modMapSingle.<K> and modMapBatch.<K>.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include "modMap.h"
+#include "benchResults.h"
+
+#define DEF_MAX_K				64
+#define DEF_IN_WORDS			64			// 1024 QPSK symbols
+#define DEF_REPEATS				200
+#define DEF_EVICT_KIB			4096
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void evict(uint8_t* buf, size_t bytes, int round)
+{
+	size_t i;
+	for (i = 0; i < bytes; i += 64) {
+		buf[i] = (uint8_t)(i + round);
+	}
+}
+
+static uint64_t median(uint64_t* samples, int count)
+{
+	qsort(samples, count, sizeof(uint64_t), benchCompareU64);
+	return samples[count / 2];
+}
+
+int main(int argc, char* argv[])
+{
+	modMapCfg_t cfg = { 2, 0.9, 64 };
+	modMapCtx_t ctx;
+	uint32_t maxK = DEF_MAX_K, k, f;
+	size_t inWords = DEF_IN_WORDS, outWords;
+	size_t evictBytes = (size_t)DEF_EVICT_KIB * 1024;
+	int repeats = DEF_REPEATS, r, opt;
+	uint32_t** in;
+	uint32_t** out;
+	uint32_t** ref;
+	uint64_t* singleNs;
+	uint64_t* batchNs;
+	uint8_t* evictBuf;
+
+	while ((opt = getopt(argc, argv, "k:w:b:g:r:n:e:h")) != -1) {
+		switch (opt) {
+		case 'k': maxK = strtoul(optarg, NULL, 0); break;
+		case 'w': inWords = strtoul(optarg, NULL, 0); break;
+		case 'b': cfg.bitsPerSym = strtoul(optarg, NULL, 0); break;
+		case 'g': cfg.gain = atof(optarg); break;
+		case 'r': cfg.rotPeriod = strtoul(optarg, NULL, 0); break;
+		case 'n': repeats = atoi(optarg); break;
+		case 'e': evictBytes = strtoul(optarg, NULL, 0) * 1024; break;
+		default:
+			maxK = 0;
+			break;
+		}
+	}
+	if (maxK == 0 || inWords == 0 || repeats <= 0 || !modMapCfgValid(&cfg)) {
+		printf("usage: %s [-k maxK] [-w inWords] [-b 1|2|4|8] [-g gain] "
+				"[-r rotPeriod] [-n repeats] [-e evictKiB]\n", argv[0]);
+		return 1;
+	}
+	outWords = modMapOutWords(&cfg, inWords);
+
+	in = calloc(maxK, sizeof(uint32_t*));
+	out = calloc(maxK, sizeof(uint32_t*));
+	ref = calloc(maxK, sizeof(uint32_t*));
+	singleNs = calloc(repeats, sizeof(uint64_t));
+	batchNs = calloc(repeats, sizeof(uint64_t));
+	evictBuf = malloc(evictBytes ? evictBytes : 1);
+	if (in == NULL || out == NULL || ref == NULL || singleNs == NULL ||
+			batchNs == NULL || evictBuf == NULL) {
+		printf("cannot allocate the frame buffers\n");
+		return 1;
+	}
+	srand(1);
+	for (f = 0; f < maxK; ++f) {
+		size_t w;
+		in[f] = malloc(inWords * sizeof(uint32_t));
+		out[f] = malloc(outWords * sizeof(uint32_t));
+		ref[f] = malloc(outWords * sizeof(uint32_t));
+		if (in[f] == NULL || out[f] == NULL || ref[f] == NULL) {
+			printf("cannot allocate the frame buffers\n");
+			return 1;
+		}
+		for (w = 0; w < inWords; ++w) {
+			in[f][w] = (uint32_t)rand() << 16 ^ (uint32_t)rand();
+		}
+	}
+
+	printf("\n%zu input words, %zu symbols per frame, %u bits per symbol, "
+			"%d repeats, %s cache\n\n", inWords, outWords, cfg.bitsPerSym,
+			repeats, evictBytes ? "cold" : "warm");
+	printf("%6s %14s %14s %8s\n", "K", "single ns/fr", "batch ns/fr",
+			"speedup");
+	// powers of two, then maxK itself when it is not one
+	for (k = 1; k <= maxK; k = (k < maxK && 2 * k > maxK) ? maxK : 2 * k) {
+		char name[32], config[128];
+		uint64_t single, batch, t0;
+
+		for (r = 0; r < repeats; ++r) {
+			evict(evictBuf, evictBytes, r);
+			t0 = nowNs();
+			for (f = 0; f < k; ++f) {
+				modMapFrame(&ctx, &cfg, in[f], ref[f], inWords);
+			}
+			singleNs[r] = (nowNs() - t0) / k;
+
+			evict(evictBuf, evictBytes, r);
+			t0 = nowNs();
+			modMapBatch(&ctx, &cfg, (const uint32_t* const*)in, out, inWords,
+					k);
+			batchNs[r] = (nowNs() - t0) / k;
+		}
+		for (f = 0; f < k; ++f) {
+			if (memcmp(out[f], ref[f], outWords * sizeof(uint32_t)) != 0) {
+				printf("batch output of frame %u differs\n", f);
+				return 1;
+			}
+		}
+
+		snprintf(config, sizeof(config), "K=%u inWords=%zu bits=%u gain=%g "
+				"rotPeriod=%u evictKiB=%zu", k, inWords, cfg.bitsPerSym,
+				cfg.gain, cfg.rotPeriod, evictBytes / 1024);
+		snprintf(name, sizeof(name), "modMapSingle.%u", k);
+		benchResultWrite(name, config, singleNs, repeats);
+		snprintf(name, sizeof(name), "modMapBatch.%u", k);
+		benchResultWrite(name, config, batchNs, repeats);
+
+		single = median(singleNs, repeats);
+		batch = median(batchNs, repeats);
+		printf("%6u %14llu %14llu %7.2fx\n", k, (unsigned long long)single,
+				(unsigned long long)batch,
+				batch ? (double)single / batch : 0.0);
+	}
+
+	for (f = 0; f < maxK; ++f) {
+		free(in[f]);
+		free(out[f]);
+		free(ref[f]);
+	}
+	free(in);
+	free(out);
+	free(ref);
+	free(singleNs);
+	free(batchNs);
+	free(evictBuf);
+	return 0;
+}
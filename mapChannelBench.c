@@ -0,0 +1,169 @@
+/*****************************************************************************
+ *
+ * mapChannelBench.c
+ *
+ * Measures how the mapping scales with the number of mapChannels.h
+ * channels, for one channel up to the maximum given.
+ *
+ * 		mapChannelBench [-n maxChannels] [-d seconds] [-i periodUs]
+ * 						[-p rtPriority] [-w words] [-c firstCpu]
+ *
+ * Every step runs N channels for the given time, all with the same period
+ * and priority, and reports each channel's execution time and wakeup
+ * jitter and the aggregate frames per second.  -c spreads the channels
+ * round robin over the cpus from firstCpu up, by default they are not
+ * pinned.  A zero period runs every channel back to back, which gives the
+ * aggregate throughput limit instead of the jitter at a given load.  The
+ * wakeup samples of all channels of a step are stored as mapChannels.<N>.
+ *
+ * Built with -DHAVE_HW_MAP next to hardwareMapSoC.h the channels run
+ * calcModAndMapBits over MAX_SIZE words, otherwise a stand-in kernel that
+ * maps every 2 bit symbol of the buffer through a constellation table.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "mapChannels.h"
+#include "benchResults.h"
+#ifdef HAVE_HW_MAP
+#include "hardwareMapSoC.h"
+#endif
+
+#define DEF_SECONDS				5
+#define DEF_PERIOD_US			1000
+#define DEF_WORDS				4096
+#define MAX_SAMPLES_PER_CHAN	(BENCH_MAX_SAMPLES / MAP_MAX_CHANNELS)
+
+#ifdef HAVE_HW_MAP
+static void benchMap(uint32_t* buf, size_t words)
+{
+	(void)words;
+	calcModAndMapBits(buf);
+}
+#else
+// QPSK style stand-in, 16 symbols per word, each symbol looked up and
+// packed back with its neighbours
+static void benchMap(uint32_t* buf, size_t words)
+{
+	static const uint32_t constellation[4] = { 0x5A, 0xA5, 0x3C, 0xC3 };
+	size_t i;
+	int s;
+	for (i = 0; i < words; ++i) {
+		uint32_t in = buf[i] ^ (uint32_t)i, out = 0;
+		for (s = 0; s < 16; ++s) {
+			out = (out << 2 | out >> 30) ^ constellation[(in >> (2 * s)) & 3];
+		}
+		buf[i] = out;
+	}
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+	static mapChannel_t ch[MAP_MAX_CHANNELS];
+	int started[MAP_MAX_CHANNELS];
+	static uint64_t samples[MAP_MAX_CHANNELS * MAX_SAMPLES_PER_CHAN];
+	volatile int stop;
+	int maxChannels = MAP_MAX_CHANNELS;
+	int seconds = DEF_SECONDS;
+	int periodUs = DEF_PERIOD_US;
+	int rtPriority = 0;
+	int firstCpu = -1;
+	size_t words = DEF_WORDS;
+	long numCpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int n, c, opt;
+
+	while ((opt = getopt(argc, argv, "n:d:i:p:w:c:h")) != -1) {
+		switch (opt) {
+		case 'n': maxChannels = atoi(optarg); break;
+		case 'd': seconds = atoi(optarg); break;
+		case 'i': periodUs = atoi(optarg); break;
+		case 'p': rtPriority = atoi(optarg); break;
+		case 'w': words = strtoul(optarg, NULL, 0); break;
+		case 'c': firstCpu = atoi(optarg); break;
+		default:
+			maxChannels = 0;
+			break;
+		}
+	}
+#ifdef HAVE_HW_MAP
+	words = MAX_SIZE;
+#endif
+	if (maxChannels < 1 || maxChannels > MAP_MAX_CHANNELS || seconds <= 0 ||
+			periodUs < 0 || words == 0) {
+		printf("usage: %s [-n maxChannels] [-d seconds] [-i periodUs] "
+				"[-p rtPriority] [-w words] [-c firstCpu]\n", argv[0]);
+		return 1;
+	}
+	if (rtPriority > 0) {
+		printf("\nlocking memory...\n\n");
+		mlockall(MCL_CURRENT | MCL_FUTURE);
+	}
+
+	printf("\n%zu words per frame, period %d usec, %d sec per step\n\n",
+			words, periodUs, seconds);
+	for (n = 1; n <= maxChannels; ++n) {
+		char name[32], config[128];
+		uint64_t frames = 0, worstP99 = 0;
+		uint32_t numSamples = 0;
+
+		stop = 0;
+		for (c = 0; c < n; ++c) {
+			if (mapChannelInit(&ch[c], c, n, words, benchMap,
+					fpgaMemBase(NULL)) != 0) {
+				return 1;
+			}
+			ch[c].periodUs = periodUs;
+			ch[c].priority = rtPriority;
+			ch[c].cpu = (firstCpu < 0) ? -1 : (int)((firstCpu + c) % numCpus);
+			ch[c].maxSamples = MAX_SAMPLES_PER_CHAN;
+		}
+		// start all channels before any is released
+		for (c = 0; c < n; ++c) {
+			started[c] = (mapChannelStart(&ch[c], &stop) == 0);
+		}
+		sleep(seconds);
+		stop = 1;
+
+		printf("%d channel%s\n", n, (n == 1) ? "" : "s");
+		for (c = 0; c < n; ++c) {
+			// a channel that failed to start has no thread to join
+			if (!started[c]) {
+				mapChannelFree(&ch[c]);
+				continue;
+			}
+			mapChannelJoin(&ch[c]);
+			mapChannelReport(&ch[c], stdout);
+			frames += ch[c].cycles;
+			if (phaseHistPercentile(&ch[c].wakeup, 99) > worstP99) {
+				worstP99 = phaseHistPercentile(&ch[c].wakeup, 99);
+			}
+			memcpy(&samples[numSamples], ch[c].samples,
+					ch[c].numSamples * sizeof(uint64_t));
+			numSamples += ch[c].numSamples;
+			mapChannelFree(&ch[c]);
+		}
+		printf("aggregate %.0f frames/sec, %.1f MB/sec, worst channel jitter "
+				"p99 %.1f usec\n\n", (double)frames / seconds,
+				(double)frames * words * sizeof(uint32_t) / seconds / 1e6,
+				worstP99 / 1e3);
+
+		if (numSamples != 0) {
+			snprintf(name, sizeof(name), "mapChannels.%d", n);
+			snprintf(config, sizeof(config), "periodUs=%d priority=%d "
+					"words=%zu firstCpu=%d", periodUs, rtPriority, words,
+					firstCpu);
+			benchResultWrite(name, config, samples, numSamples);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,216 @@
+/*****************************************************************************
+ *
+ * mapChannels.h
+ *
+ * Independent mapping channels, each a periodic thread with its own period,
+ * cpu, priority and buffer, so several antenna channels can be mapped on
+ * the same SoC without sharing any state in the RT path.
+ *
+ * A channel's buffer is page aligned and allocated separately, so no two
+ * channels share a cache line.  The FPGA RAM measurement array is split
+ * into equal slices, channel n writes the execution time of each cycle
+ * only into slice n, so the channels never write the same FPGA words and
+ * need no lock around the RAM.  On a host without /dev/mem the FPGA base is
+ * NULL and nothing is written.
+ *
+ * Each release is planned on an absolute CLOCK_MONOTONIC schedule, the
+ * wakeup latency (jitter) and the execution time of every cycle go into
+ * per-channel histograms.  A zero period runs the channel back to back,
+ * which measures the throughput limit.  The map function is called with
+ * the channel's buffer and its size in words, it must keep no state outside
+ * the buffer for channels to be independent.
+ *
+ * 		mapChannelInit(&ch[i], i, numChannels, words, mapFunc, fpgaBase);
+ * 		ch[i].periodUs = 100000;  ch[i].cpu = 1;  ch[i].priority = 90;
+ * 		mapChannelStart(&ch[i], &stop);
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef MAP_CHANNELS_H
+#define MAP_CHANNELS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <pthread.h>
+#include <time.h>
+#include "socRegMap.h"
+#include "phaseBudget.h"
+
+#define MAP_MAX_CHANNELS		4			// antenna channels on the SoC
+#define MAP_CHAN_PAGE			4096
+
+typedef void (*mapFunc_t)(uint32_t* buf, size_t words);
+
+typedef struct {
+	// configuration, set between mapChannelInit and mapChannelStart
+	uint32_t periodUs;			// zero runs back to back
+	int cpu;					// -1 when not pinned
+	int priority;				// SCHED_FIFO priority, zero for SCHED_OTHER
+	uint32_t count;				// cycles to run, zero until stopped
+	uint32_t maxSamples;		// wakeup samples kept, zero for none
+
+	// run state, owned by the channel thread while it runs
+	int id;
+	mapFunc_t map;
+	uint32_t* buf;
+	size_t bufWords;
+	volatile uint32_t* fpgaArr;	// this channel's slice of the FPGA array
+	uint32_t fpgaWords;
+	volatile int* stop;
+	pthread_t tid;
+	uint32_t cycles;
+	uint32_t overruns;			// cycles that ended after the next release
+	uint32_t measurementCnt;	// FPGA words written
+	phaseHist_t wakeup;
+	phaseHist_t exec;
+	uint64_t* samples;
+	uint32_t numSamples;
+} mapChannel_t;
+
+// returns -1 when the buffer cannot be allocated, fpgaMem is the mapping of
+// HPS_FPGA_MEM_BASE or fpgaMemBase(NULL)
+static inline int mapChannelInit(mapChannel_t* ch, int id, int numChannels,
+		size_t words, mapFunc_t map, fpgaMemBase_t fpgaMem)
+{
+	void* buf;
+
+	memset(ch, 0, sizeof(*ch));
+	ch->id = id;
+	ch->cpu = -1;
+	ch->map = map;
+	ch->bufWords = words;
+	if (posix_memalign(&buf, MAP_CHAN_PAGE, words * sizeof(uint32_t)) != 0) {
+		printf("channel %d: cannot allocate the mapping buffer\n", id);
+		return -1;
+	}
+	memset(buf, 0, words * sizeof(uint32_t));
+	ch->buf = buf;
+	if (fpgaMem.p != NULL) {
+		ch->fpgaWords = fpgaRamArrCount / numChannels;
+		ch->fpgaArr = fpgaRamArrPtr(fpgaMem) + id * ch->fpgaWords;
+	}
+	return 0;
+}
+
+static inline void mapChannelFree(mapChannel_t* ch)
+{
+	free(ch->buf);
+	free(ch->samples);
+	ch->buf = NULL;
+	ch->samples = NULL;
+}
+
+static inline uint64_t mapChanNowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline void* mapChannelTask(void* arg)
+{
+	mapChannel_t* ch = (mapChannel_t*)arg;
+	struct timespec next;
+	uint64_t planned, start, end;
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	while (!*ch->stop && (ch->count == 0 || ch->cycles < ch->count)) {
+		next.tv_nsec += (long)ch->periodUs * 1000;
+		while (next.tv_nsec >= 1000000000L) {
+			next.tv_nsec -= 1000000000L;
+			next.tv_sec++;
+		}
+		if (ch->periodUs != 0) {
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+		}
+		planned = (uint64_t)next.tv_sec * 1000000000ULL + next.tv_nsec;
+		start = mapChanNowNs();
+		ch->map(ch->buf, ch->bufWords);
+		end = mapChanNowNs();
+
+		if (ch->measurementCnt < ch->fpgaWords) {
+			SOC_REG_BARRIER();
+			ch->fpgaArr[ch->measurementCnt++] = (uint32_t)(end - start);
+		}
+		phaseHistAdd(&ch->exec, end - start);
+		if (ch->periodUs != 0) {
+			phaseHistAdd(&ch->wakeup, start - planned);
+			if (ch->numSamples < ch->maxSamples) {
+				ch->samples[ch->numSamples++] = start - planned;
+			}
+			// skip releases already missed instead of running them back to back
+			if (end > planned + (uint64_t)ch->periodUs * 1000) {
+				ch->overruns++;
+				clock_gettime(CLOCK_MONOTONIC, &next);
+			}
+		}
+		ch->cycles++;
+	}
+	return NULL;
+}
+
+// start the channel thread, it runs until *stop is set or count cycles
+static inline int mapChannelStart(mapChannel_t* ch, volatile int* stop)
+{
+	struct sched_param my_params;
+	pthread_attr_t attr;
+	cpu_set_t cpuSet;
+	int rc;
+
+	ch->stop = stop;
+	if (ch->maxSamples != 0 && ch->samples == NULL) {
+		ch->samples = calloc(ch->maxSamples, sizeof(uint64_t));
+		if (ch->samples == NULL) {
+			ch->maxSamples = 0;
+		}
+	}
+	pthread_attr_init(&attr);
+	if (ch->priority > 0) {
+		pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+		pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+		my_params.sched_priority = ch->priority;
+		pthread_attr_setschedparam(&attr, &my_params);
+	}
+	if (ch->cpu >= 0) {
+		CPU_ZERO(&cpuSet);
+		CPU_SET(ch->cpu, &cpuSet);
+		pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuSet);
+	}
+	rc = pthread_create(&ch->tid, &attr, mapChannelTask, ch);
+	if (rc != 0 && ch->priority > 0) {
+		// without CAP_SYS_NICE fall back to the default policy
+		printf("channel %d: could not start with RT policy, using defaults\n",
+				ch->id);
+		pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+		rc = pthread_create(&ch->tid, &attr, mapChannelTask, ch);
+	}
+	pthread_attr_destroy(&attr);
+	if (rc != 0) {
+		printf("channel %d: could not start\n", ch->id);
+		return -1;
+	}
+	return 0;
+}
+
+static inline void mapChannelJoin(mapChannel_t* ch)
+{
+	pthread_join(ch->tid, NULL);
+}
+
+static inline void mapChannelReport(const mapChannel_t* ch, FILE* out)
+{
+	fprintf(out, "channel %d cpu %2d prio %2d %8u cycles %5u late  "
+			"exec p50 %9.1f max %9.1f  jitter p50 %7.1f p99 %7.1f max %8.1f "
+			"usec\n", ch->id, ch->cpu, ch->priority, ch->cycles, ch->overruns,
+			phaseHistPercentile(&ch->exec, 50) / 1e3, ch->exec.maxNs / 1e3,
+			phaseHistPercentile(&ch->wakeup, 50) / 1e3,
+			phaseHistPercentile(&ch->wakeup, 99) / 1e3,
+			ch->wakeup.maxNs / 1e3);
+}
+
+#endif // MAP_CHANNELS_H
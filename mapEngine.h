@@ -0,0 +1,281 @@
+/*****************************************************************************
+ *
+ * mapEngine.h
+ *
+ * Shared memory link between the hardware mapping engine and the I/O
+ * process when the engine runs as its own RT process instead of a thread.
+ *
+ * The segment (MAP_ENGINE_SHM) holds two single producer, single consumer
+ * rings of fixed size messages, one towards the engine and one back to the
+ * I/O process.  Pushing never blocks, a full ring drops the message and
+ * counts it, so the RT engine can never be held up by a stalled I/O
+ * process.  Popping can block on a futex in the ring's head word, which is
+ * a process-shared futex (no FUTEX_PRIVATE_FLAG) since the two ends live
+ * in different address spaces.  The producer only makes the wake system
+ * call when the consumer has announced it is about to sleep.
+ *
+ * The segment is a named POSIX shared memory object, so a restarted I/O
+ * process can attach to a running engine with mapEngineShmMap(0), and
+ * mapEngineRunning tells whether the engine behind an existing segment is
+ * still beating.  The I/O side waits for messages with a bounded timeout
+ * and treats a heartbeat older than MAP_ENGINE_LOST_MS, long enough for a
+ * standby to have taken over, as a lost engine.
+ *
+ * The segment also carries the hot-standby state.  The active engine beats
+ * a heartbeat several times per cycle and mirrors the state a successor
+ * needs (loop and measurement counts).  A standby process with /dev/mem
+ * already mapped and its memory locked polls the heartbeat, and when it is
+ * older than MAP_HEARTBEAT_TIMEOUT_MS it kills the stalled engine, claims
+ * activePid and continues from the mirrored state.  An engine that finds
+ * it is no longer the active one stops writing outputs.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef MAP_ENGINE_H
+#define MAP_ENGINE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define MAP_ENGINE_SHM			"/mapEngine"
+#define MAP_RING_SLOTS			64			// messages per ring, power of two
+#define MAP_CACHE_LINE			64
+#define MAP_HEARTBEAT_TIMEOUT_MS	150		// longest beat gap is one 100 ms wait
+#define MAP_STANDBY_POLL_MS		5			// standby heartbeat check period
+#define MAP_ENGINE_LOST_MS		(4 * MAP_HEARTBEAT_TIMEOUT_MS)	// no takeover
+
+// message types
+enum {
+	MAP_MSG_LOOP_CNT,		// I/O to engine, value is the shared loop count
+	MAP_MSG_STOP,			// I/O to engine, finish the current cycle and exit
+	MAP_MSG_DONE,			// engine to I/O, one mapping cycle completed
+	MAP_MSG_EXIT,			// engine to I/O, value is the measurement count
+	MAP_MSG_PING,			// benchmark request and reply
+	MAP_MSG_PONG
+};
+
+typedef struct {
+	uint32_t type;
+	uint32_t cycle;
+	uint32_t value;
+	uint32_t spare;
+	uint64_t sentNs;			// CLOCK_MONOTONIC time of the push
+	uint64_t auxNs;				// type specific, e.g. mapping time
+} mapMsg_t;
+
+// head and tail on separate cache lines, the producer only writes head and
+// the consumer only writes tail and sleeping
+typedef struct {
+	uint32_t head;
+	uint32_t dropped;			// messages lost to a full ring
+	char padHead[MAP_CACHE_LINE - 2 * sizeof(uint32_t)];
+	uint32_t tail;
+	uint32_t sleeping;			// consumer is blocked on head
+	char padTail[MAP_CACHE_LINE - 2 * sizeof(uint32_t)];
+	mapMsg_t msg[MAP_RING_SLOTS];
+} mapRing_t;
+
+// written by the active engine, read by the standby and the I/O process
+typedef struct {
+	uint32_t activePid;			// engine that owns the outputs
+	uint32_t heartbeat;			// bumped by the active engine
+	uint64_t lastBeatNs;		// CLOCK_MONOTONIC time of the last beat
+	uint32_t done;				// active engine finished normally
+	uint32_t failovers;
+	uint64_t failoverNs;		// last beat to takeover of the last failover
+	uint32_t loopCnt;			// mirrored engine state
+	uint32_t measurementCnt;
+} mapEngineState_t;
+
+typedef struct {
+	mapRing_t toEngine;
+	mapRing_t fromEngine;
+	uint32_t enginePid;
+	uint32_t flightSeq;			// flight recorder counter shared by both ends
+	mapEngineState_t state;
+} mapEngineShm_t;
+
+static inline uint64_t mapNowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline long mapFutexWait(uint32_t* addr, uint32_t val,
+		const struct timespec* timeout)
+{
+	return syscall(SYS_futex, addr, FUTEX_WAIT, val, timeout, NULL, 0);
+}
+
+static inline long mapFutexWake(uint32_t* addr, int count)
+{
+	return syscall(SYS_futex, addr, FUTEX_WAKE, count, NULL, NULL, 0);
+}
+
+// producer side, returns -1 and counts the drop when the ring is full
+static inline int mapRingPush(mapRing_t* r, const mapMsg_t* m)
+{
+	uint32_t head = r->head;
+	if (head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) == MAP_RING_SLOTS) {
+		r->dropped++;
+		return -1;
+	}
+	r->msg[head & (MAP_RING_SLOTS - 1)] = *m;
+	r->msg[head & (MAP_RING_SLOTS - 1)].sentNs = mapNowNs();
+	__atomic_store_n(&r->head, head + 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&r->sleeping, __ATOMIC_SEQ_CST)) {
+		mapFutexWake(&r->head, 1);
+	}
+	return 0;
+}
+
+// consumer side, waits up to timeoutMs for a message, zero polls and a
+// negative timeout waits forever, returns 1 when a message was copied out
+static inline int mapRingPop(mapRing_t* r, mapMsg_t* m, int timeoutMs)
+{
+	uint32_t tail = r->tail;
+	uint32_t head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+	struct timespec ts, *tsp = NULL;
+
+	if (timeoutMs > 0) {
+		ts.tv_sec = timeoutMs / 1000;
+		ts.tv_nsec = (long)(timeoutMs % 1000) * 1000000L;
+		tsp = &ts;
+	}
+	while (head == tail) {
+		if (timeoutMs == 0) {
+			return 0;
+		}
+		// announce the sleep, then recheck so a push in between is not lost
+		__atomic_store_n(&r->sleeping, 1, __ATOMIC_SEQ_CST);
+		head = __atomic_load_n(&r->head, __ATOMIC_SEQ_CST);
+		if (head == tail) {
+			if (mapFutexWait(&r->head, tail, tsp) == -1 &&
+					errno == ETIMEDOUT) {
+				__atomic_store_n(&r->sleeping, 0, __ATOMIC_RELAXED);
+				return 0;
+			}
+			head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+		}
+		__atomic_store_n(&r->sleeping, 0, __ATOMIC_RELAXED);
+	}
+	*m = r->msg[tail & (MAP_RING_SLOTS - 1)];
+	__atomic_store_n(&r->tail, tail + 1, __ATOMIC_RELEASE);
+	return 1;
+}
+
+// active engine, called several times per cycle
+static inline void mapEngineBeat(mapEngineShm_t* shm)
+{
+	__atomic_store_n(&shm->state.lastBeatNs, mapNowNs(), __ATOMIC_RELAXED);
+	__atomic_add_fetch(&shm->state.heartbeat, 1, __ATOMIC_RELEASE);
+}
+
+static inline int mapEngineIsActive(mapEngineShm_t* shm)
+{
+	return __atomic_load_n(&shm->state.activePid, __ATOMIC_ACQUIRE) ==
+			(uint32_t)getpid();
+}
+
+// I/O side, msec since the active engine's last beat, -1 before the first
+static inline int64_t mapEngineBeatAgeMs(mapEngineShm_t* shm)
+{
+	uint64_t last = __atomic_load_n(&shm->state.lastBeatNs, __ATOMIC_RELAXED);
+	return last ? (int64_t)((mapNowNs() - last) / 1000000ULL) : -1;
+}
+
+// I/O side, an engine owns the outputs, has not finished and is beating
+static inline int mapEngineRunning(mapEngineShm_t* shm)
+{
+	int64_t age = mapEngineBeatAgeMs(shm);
+	return __atomic_load_n(&shm->state.activePid, __ATOMIC_ACQUIRE) != 0 &&
+			!__atomic_load_n(&shm->state.done, __ATOMIC_ACQUIRE) &&
+			age >= 0 && age < MAP_HEARTBEAT_TIMEOUT_MS;
+}
+
+// active engine, publish what a successor needs to carry on
+static inline void mapEngineMirror(mapEngineShm_t* shm, uint32_t loopCnt,
+		uint32_t measurementCnt)
+{
+	shm->state.loopCnt = loopCnt;
+	shm->state.measurementCnt = measurementCnt;
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+// standby, wait until the active engine stalls or finishes, returns 1 when
+// this process has taken over and 0 when the engine finished normally
+static inline int mapStandbyWait(mapEngineShm_t* shm)
+{
+	struct timespec poll = { 0, MAP_STANDBY_POLL_MS * 1000000L };
+	uint64_t lastBeat, now;
+	uint32_t active;
+
+	for (;;) {
+		nanosleep(&poll, NULL);
+		if (__atomic_load_n(&shm->state.done, __ATOMIC_ACQUIRE)) {
+			return 0;
+		}
+		active = __atomic_load_n(&shm->state.activePid, __ATOMIC_ACQUIRE);
+		lastBeat = __atomic_load_n(&shm->state.lastBeatNs, __ATOMIC_RELAXED);
+		now = mapNowNs();
+		if (active == 0 || now - lastBeat <
+				(uint64_t)MAP_HEARTBEAT_TIMEOUT_MS * 1000000ULL) {
+			continue;
+		}
+		// fence the stalled engine before taking its outputs
+		if (!__atomic_compare_exchange_n(&shm->state.activePid, &active,
+				(uint32_t)getpid(), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			continue;
+		}
+		kill((pid_t)active, SIGKILL);
+		shm->state.failoverNs = mapNowNs() - lastBeat;
+		shm->state.failovers++;
+		mapEngineBeat(shm);
+		return 1;
+	}
+}
+
+// map the shared segment, create resets it, returns NULL on failure
+static inline mapEngineShm_t* mapEngineShmMap(int create)
+{
+	mapEngineShm_t* shm;
+	int fd = shm_open(MAP_ENGINE_SHM, O_RDWR | (create ? O_CREAT : 0), 0600);
+	if (fd == -1) {
+		return NULL;
+	}
+	if (create && ftruncate(fd, sizeof(mapEngineShm_t)) == -1) {
+		close(fd);
+		return NULL;
+	}
+	shm = mmap(NULL, sizeof(mapEngineShm_t), PROT_READ | PROT_WRITE,
+			MAP_SHARED, fd, 0);
+	close(fd);
+	if (shm == MAP_FAILED) {
+		return NULL;
+	}
+	if (create) {
+		memset(shm, 0, sizeof(*shm));
+	}
+	return shm;
+}
+
+static inline void mapEngineShmUnmap(mapEngineShm_t* shm, int unlink)
+{
+	munmap(shm, sizeof(*shm));
+	if (unlink) {
+		shm_unlink(MAP_ENGINE_SHM);
+	}
+}
+
+#endif // MAP_ENGINE_H
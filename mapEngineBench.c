@@ -0,0 +1,246 @@
+/*****************************************************************************
+ *
+ * mapEngineBench.c
+ *
+ * Measures the latency the mapEngine.h link adds when the mapping engine
+ * runs as a separate process instead of a thread of the I/O process.
+ *
+ * A requester pushes a ping once per interval and blocks for the reply, a
+ * responder blocks on the ring's futex and answers at once.  The same
+ * rings and futex code are used with the responder as a thread and as a
+ * forked process, so the difference between the two runs is the cost of
+ * crossing the address space boundary: the wakeup through a shared futex,
+ * the extra TLB and cache footprint of a second mm.  The one-way latency
+ * (push to responder wakeup) and the round trip are reported and the
+ * one-way samples are stored as mapEngine.thread and mapEngine.process.
+ *
+ * 		mapEngineBench [-n count] [-i intervalUs] [-p rtPriority]
+ * 					   [-c responderCpu] [-C requesterCpu] [-m both|thread|process]
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "mapEngine.h"
+#include "benchResults.h"
+
+#define DEF_COUNT				10000
+#define DEF_INTERVAL_US			1000
+
+int count = DEF_COUNT;
+int intervalUs = DEF_INTERVAL_US;
+int rtPriority = 0;				// zero keeps SCHED_OTHER
+int responderCpu = -1;
+int requesterCpu = -1;
+
+mapEngineShm_t* shm;
+uint64_t* oneWay;
+uint64_t* roundTrip;
+
+// pin and raise the calling thread as configured
+static void setupSelf(int cpu)
+{
+	struct sched_param my_params;
+	cpu_set_t cpuSet;
+
+	if (cpu >= 0) {
+		CPU_ZERO(&cpuSet);
+		CPU_SET(cpu, &cpuSet);
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+				&cpuSet) != 0) {
+			printf("could not set processor affinity...\n");
+		}
+	}
+	if (rtPriority > 0) {
+		my_params.sched_priority = rtPriority;
+		if (pthread_setschedparam(pthread_self(), SCHED_FIFO,
+				&my_params) != 0) {
+			printf("could not change scheduler policy\n");
+		}
+	}
+}
+
+// answer every ping with the time it took to arrive
+static void* responder(void* arg)
+{
+	mapMsg_t req, reply;
+	(void)arg;
+
+	setupSelf(responderCpu);
+	memset(&reply, 0, sizeof(reply));
+	reply.type = MAP_MSG_PONG;
+	while (mapRingPop(&shm->toEngine, &req, -1)) {
+		if (req.type == MAP_MSG_STOP) {
+			break;
+		}
+		reply.cycle = req.cycle;
+		reply.auxNs = mapNowNs() - req.sentNs;
+		mapRingPush(&shm->fromEngine, &reply);
+	}
+	return NULL;
+}
+
+static void requester(void)
+{
+	mapMsg_t req, reply;
+	struct timespec next;
+	uint64_t t0;
+	int i;
+
+	setupSelf(requesterCpu);
+	memset(&req, 0, sizeof(req));
+	req.type = MAP_MSG_PING;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	for (i = 0; i < count; ++i) {
+		// pace the pings so the responder is asleep when each one arrives
+		next.tv_nsec += (long)intervalUs * 1000;
+		while (next.tv_nsec >= 1000000000L) {
+			next.tv_nsec -= 1000000000L;
+			next.tv_sec++;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+		req.cycle = i;
+		t0 = mapNowNs();
+		mapRingPush(&shm->toEngine, &req);
+		if (!mapRingPop(&shm->fromEngine, &reply, 1000)) {
+			printf("no reply to ping %d, stopping...\n", i);
+			break;
+		}
+		roundTrip[i] = mapNowNs() - t0;
+		oneWay[i] = reply.auxNs;
+	}
+	count = i;
+	req.type = MAP_MSG_STOP;
+	mapRingPush(&shm->toEngine, &req);
+}
+
+static void report(const char* mode, const char* what, uint64_t* samples)
+{
+	uint64_t sum = 0;
+	int i;
+	for (i = 0; i < count; ++i) {
+		sum += samples[i];
+	}
+	qsort(samples, count, sizeof(uint64_t), benchCompareU64);
+	printf("%-8s %-10s %9llu %9llu %9llu %9llu %9llu\n", mode, what,
+			(unsigned long long)samples[0],
+			(unsigned long long)(sum / count),
+			(unsigned long long)samples[count / 2],
+			(unsigned long long)samples[(count * 99) / 100],
+			(unsigned long long)samples[count - 1]);
+}
+
+static int runMode(int useProcess)
+{
+	const char* mode = useProcess ? "process" : "thread";
+	char name[64], config[128];
+	pthread_t respVar;
+	pid_t pid = -1;
+
+	memset(shm, 0, sizeof(*shm));
+	if (useProcess) {
+		fflush(stdout);
+		pid = fork();
+		if (pid == 0) {
+			responder(NULL);
+			_exit(0);
+		}
+		if (pid == -1) {
+			printf("cannot fork the responder process\n");
+			return -1;
+		}
+	}
+	else {
+		pthread_create(&respVar, NULL, responder, NULL);
+	}
+
+	requester();
+	if (useProcess) {
+		waitpid(pid, NULL, 0);
+	}
+	else {
+		pthread_join(respVar, NULL);
+	}
+	if (count == 0) {
+		return -1;
+	}
+
+	snprintf(name, sizeof(name), "mapEngine.%s", mode);
+	snprintf(config, sizeof(config), "intervalUs=%d priority=%d cpus=%d,%d",
+			intervalUs, rtPriority, requesterCpu, responderCpu);
+	benchResultWrite(name, config, oneWay, count);
+	report(mode, "one-way", oneWay);
+	report(mode, "round trip", roundTrip);
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* modes = "both";
+	int savedCount;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:i:p:c:C:m:h")) != -1) {
+		switch (opt) {
+		case 'n': count = atoi(optarg); break;
+		case 'i': intervalUs = atoi(optarg); break;
+		case 'p': rtPriority = atoi(optarg); break;
+		case 'c': responderCpu = atoi(optarg); break;
+		case 'C': requesterCpu = atoi(optarg); break;
+		case 'm': modes = optarg; break;
+		default:
+			count = 0;
+			break;
+		}
+	}
+	if (count <= 0 || intervalUs <= 0 || (strcmp(modes, "both") != 0 &&
+			strcmp(modes, "thread") != 0 && strcmp(modes, "process") != 0)) {
+		printf("usage: %s [-n count] [-i intervalUs] [-p rtPriority] "
+				"[-c responderCpu] [-C requesterCpu] [-m both|thread|process]"
+				"\n", argv[0]);
+		return 1;
+	}
+
+	// anonymous shared memory is shared with a forked child and between
+	// threads alike, so both modes run over the same kind of mapping
+	shm = mmap(NULL, sizeof(*shm), PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	oneWay = calloc(count, sizeof(uint64_t));
+	roundTrip = calloc(count, sizeof(uint64_t));
+	if (shm == MAP_FAILED || oneWay == NULL || roundTrip == NULL) {
+		printf("cannot allocate the benchmark buffers\n");
+		return 1;
+	}
+	if (rtPriority > 0) {
+		printf("\nlocking memory...\n\n");
+		mlockall(MCL_CURRENT | MCL_FUTURE);
+	}
+
+	printf("\n%d pings every %d usec (nsec)\n\n", count, intervalUs);
+	printf("%-8s %-10s %9s %9s %9s %9s %9s\n", "mode", "", "min", "avg",
+			"p50", "p99", "max");
+	savedCount = count;
+	if (strcmp(modes, "process") != 0) {
+		runMode(0);
+	}
+	count = savedCount;
+	if (strcmp(modes, "thread") != 0) {
+		runMode(1);
+	}
+
+	munmap(shm, sizeof(*shm));
+	free(oneWay);
+	free(roundTrip);
+	return 0;
+}
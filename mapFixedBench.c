@@ -0,0 +1,151 @@
+/*****************************************************************************
+ *
+ * mapFixedBench.c
+ *
+ * Compares the fixed-point mapping of modMapFixed.h with the floating-point
+ * reference modMapRun, throughput and accuracy, for every modulation.
+ *
+ * 		mapFixedBench [-f fracBits] [-w inWords] [-r rotPeriod] [-g gain]
+ * 					  [-n repeats]
+ *
+ * Both paths map the same random frame repeat times with a warm cache and
+ * the median nsec per symbol is printed with the speedup.  The fixed-point
+ * output of every repeat is compared with the reference, the maximum and
+ * RMS difference are printed in Q15 LSBs next to the analytic bound, and
+ * the run fails if any component exceeds it.  Build and run it on the x86
+ * host and on the board, the per-frame times of the fixed-point path are
+ * stored as modMapFixed.<bits>.<fracBits>, with the machine in the record.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include "modMapFixed.h"
+#include "benchResults.h"
+
+#define DEF_FRAC_BITS			15
+#define DEF_IN_WORDS			64
+#define DEF_REPEATS				2000
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t median(uint64_t* samples, int count)
+{
+	qsort(samples, count, sizeof(uint64_t), benchCompareU64);
+	return samples[count / 2];
+}
+
+int main(int argc, char* argv[])
+{
+	static const uint32_t bitsList[] = { 1, 2, 4, 8 };
+	modMapCfg_t cfg = { 2, 0.9, 64 };
+	modMapCtx_t ctx;
+	modMapFixedCtx_t fx;
+	int fracBits = DEF_FRAC_BITS;
+	size_t inWords = DEF_IN_WORDS, w;
+	int repeats = DEF_REPEATS, r, opt, failed = 0;
+	uint32_t* in;
+	uint32_t* refOut;
+	uint32_t* fixedOut;
+	uint64_t* floatNs;
+	uint64_t* fixedNs;
+	unsigned b;
+
+	while ((opt = getopt(argc, argv, "f:w:r:g:n:h")) != -1) {
+		switch (opt) {
+		case 'f': fracBits = atoi(optarg); break;
+		case 'w': inWords = strtoul(optarg, NULL, 0); break;
+		case 'r': cfg.rotPeriod = strtoul(optarg, NULL, 0); break;
+		case 'g': cfg.gain = atof(optarg); break;
+		case 'n': repeats = atoi(optarg); break;
+		default:
+			repeats = 0;
+			break;
+		}
+	}
+	if (repeats <= 0 || inWords == 0 || !modMapCfgValid(&cfg) ||
+			fracBits < MOD_MAP_FIXED_MIN_FRAC ||
+			fracBits > MOD_MAP_FIXED_MAX_FRAC) {
+		printf("usage: %s [-f fracBits %d-%d] [-w inWords] [-r rotPeriod] "
+				"[-g gain] [-n repeats]\n", argv[0], MOD_MAP_FIXED_MIN_FRAC,
+				MOD_MAP_FIXED_MAX_FRAC);
+		return 1;
+	}
+	in = malloc(inWords * sizeof(uint32_t));
+	refOut = malloc(inWords * 32 * sizeof(uint32_t));
+	fixedOut = malloc(inWords * 32 * sizeof(uint32_t));
+	floatNs = calloc(repeats, sizeof(uint64_t));
+	fixedNs = calloc(repeats, sizeof(uint64_t));
+	if (in == NULL || refOut == NULL || fixedOut == NULL || floatNs == NULL ||
+			fixedNs == NULL) {
+		printf("cannot allocate the frame buffers\n");
+		return 1;
+	}
+
+	printf("\n%zu input words, Q%d tables, %s path, rotPeriod %u, gain %g, "
+			"median nsec per symbol\n\n", inWords, fracBits,
+			(fracBits <= 15) ? "32-bit" : "64-bit", cfg.rotPeriod, cfg.gain);
+	printf("%5s %9s %9s %8s %8s %8s %8s\n", "bits", "float", "fixed",
+			"speedup", "maxLsb", "rmsLsb", "bound");
+	for (b = 0; b < sizeof(bitsList) / sizeof(bitsList[0]); ++b) {
+		size_t symbols;
+		modMapFixedErr_t err;
+		uint64_t floatMed, fixedMed, t0;
+		char name[48], config[96];
+
+		cfg.bitsPerSym = bitsList[b];
+		symbols = modMapOutWords(&cfg, inWords);
+		modMapSetup(&ctx, &cfg);
+		modMapFixedSetup(&fx, &ctx, fracBits);
+		memset(&err, 0, sizeof(err));
+		srand(b + 1);
+
+		for (r = 0; r < repeats; ++r) {
+			for (w = 0; w < inWords; ++w) {
+				in[w] = (uint32_t)rand() << 16 ^ (uint32_t)rand();
+			}
+			t0 = nowNs();
+			modMapRun(&ctx, in, refOut, inWords);
+			floatNs[r] = nowNs() - t0;
+			t0 = nowNs();
+			modMapFixedRun(&fx, in, fixedOut, inWords);
+			fixedNs[r] = nowNs() - t0;
+			modMapFixedError(&err, &fx, fixedOut, refOut, symbols);
+		}
+
+		snprintf(name, sizeof(name), "modMapFixed.%u.%d", cfg.bitsPerSym,
+				fracBits);
+		snprintf(config, sizeof(config), "inWords=%zu rotPeriod=%u gain=%g",
+				inWords, cfg.rotPeriod, cfg.gain);
+		benchResultWrite(name, config, fixedNs, repeats);
+
+		floatMed = median(floatNs, repeats);
+		fixedMed = median(fixedNs, repeats);
+		printf("%5u %9.2f %9.2f %7.2fx %8u %8.3f %8.2f%s\n", cfg.bitsPerSym,
+				(double)floatMed / symbols, (double)fixedMed / symbols,
+				fixedMed ? (double)floatMed / fixedMed : 0.0, err.maxAbs,
+				err.rms, modMapFixedBound(&fx) + 0.5,
+				err.over ? "  EXCEEDED" : "");
+		failed |= err.over != 0;
+	}
+	printf("\nbound: fixed-point bound plus the half LSB of the reference\n");
+
+	free(in);
+	free(refOut);
+	free(fixedOut);
+	free(floatNs);
+	free(fixedNs);
+	return failed;
+}
@@ -0,0 +1,194 @@
+/*****************************************************************************
+ *
+ * mapIncrBench.c
+ *
+ * Measures incremental re-mapping with modMapIncr.h against mapping the
+ * whole frame every cycle, at a given fraction of changed input.
+ *
+ * 		mapIncrBench [-w inWords] [-B blockWords] [-c changePct]
+ * 					 [-l runWords] [-n frames] [-b bitsPerSym] [-r rotPeriod]
+ *
+ * Every frame changePct percent of the input words are rewritten, in runs
+ * of runWords consecutive words at random places.  The frame is then
+ * mapped three ways, in full with modMapRun, incrementally with the dirty
+ * blocks found by modMapIncrDiff, and incrementally with the blocks marked
+ * by the writer through modMapIncrMark.  The marked run also copies its
+ * new output words to a host buffer standing in for fpgaRamBuf, sized for
+ * the whole output so every block's device write is covered.  Both
+ * incremental outputs and the device buffer are checked against the full
+ * mapping every frame.  The median nsec per frame and the fraction of
+ * blocks mapped are printed, the per-frame times are stored as
+ * modMapFull, modMapIncr.diff and modMapIncr.mark.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include "modMapIncr.h"
+#include "benchResults.h"
+
+#define DEF_IN_WORDS			1024
+#define DEF_CHANGE_PCT			3.0
+#define DEF_RUN_WORDS			4
+#define DEF_FRAMES				1000
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t median(uint64_t* samples, int count)
+{
+	qsort(samples, count, sizeof(uint64_t), benchCompareU64);
+	return samples[count / 2];
+}
+
+int main(int argc, char* argv[])
+{
+	modMapCfg_t cfg = { 2, 0.9, 64 };
+	modMapCtx_t ctx;
+	modMapIncr_t diffInc, markInc;
+	size_t inWords = DEF_IN_WORDS, blockWords = MOD_MAP_INCR_DEF_BLOCK;
+	size_t runWords = DEF_RUN_WORDS, outWords, changed, w;
+	double changePct = DEF_CHANGE_PCT;
+	int frames = DEF_FRAMES, f, opt;
+	uint32_t* in;
+	uint32_t* fullOut;
+	uint32_t* diffOut;
+	uint32_t* markOut;
+	uint32_t* devBuf;			// stands in for fpgaRamBuf
+	size_t devWords;
+	uint64_t* fullNs;
+	uint64_t* diffNs;
+	uint64_t* markNs;
+	uint64_t t0;
+	char config[128];
+
+	while ((opt = getopt(argc, argv, "w:B:c:l:n:b:r:h")) != -1) {
+		switch (opt) {
+		case 'w': inWords = strtoul(optarg, NULL, 0); break;
+		case 'B': blockWords = strtoul(optarg, NULL, 0); break;
+		case 'c': changePct = atof(optarg); break;
+		case 'l': runWords = strtoul(optarg, NULL, 0); break;
+		case 'n': frames = atoi(optarg); break;
+		case 'b': cfg.bitsPerSym = strtoul(optarg, NULL, 0); break;
+		case 'r': cfg.rotPeriod = strtoul(optarg, NULL, 0); break;
+		default:
+			frames = 0;
+			break;
+		}
+	}
+	if (frames <= 0 || inWords == 0 || blockWords == 0 || runWords == 0 ||
+			changePct < 0.0 || changePct > 100.0 || !modMapCfgValid(&cfg)) {
+		printf("usage: %s [-w inWords] [-B blockWords] [-c changePct] "
+				"[-l runWords] [-n frames] [-b bitsPerSym] [-r rotPeriod]\n",
+				argv[0]);
+		return 1;
+	}
+	modMapSetup(&ctx, &cfg);
+	outWords = modMapOutWords(&cfg, inWords);
+	in = calloc(inWords, sizeof(uint32_t));
+	fullOut = calloc(outWords, sizeof(uint32_t));
+	diffOut = calloc(outWords, sizeof(uint32_t));
+	markOut = calloc(outWords, sizeof(uint32_t));
+	devWords = outWords;
+	devBuf = calloc(devWords, sizeof(uint32_t));
+	fullNs = calloc(frames, sizeof(uint64_t));
+	diffNs = calloc(frames, sizeof(uint64_t));
+	markNs = calloc(frames, sizeof(uint64_t));
+	if (in == NULL || fullOut == NULL || diffOut == NULL || markOut == NULL ||
+			devBuf == NULL || fullNs == NULL || diffNs == NULL || markNs == NULL ||
+			modMapIncrInit(&diffInc, &ctx, inWords, blockWords) != 0 ||
+			modMapIncrInit(&markInc, &ctx, inWords, blockWords) != 0) {
+		printf("cannot allocate the frame buffers\n");
+		return 1;
+	}
+	srand(1);
+	for (w = 0; w < inWords; ++w) {
+		in[w] = (uint32_t)rand() << 16 ^ (uint32_t)rand();
+	}
+
+	changed = (size_t)(inWords * changePct / 100.0 + 0.5);
+	for (f = 0; f < frames; ++f) {
+		// the first frame is mapped in full by every variant
+		size_t done = 0;
+		while (f != 0 && done < changed) {
+			size_t first = (size_t)rand() % inWords;
+			size_t run = (runWords < changed - done) ? runWords :
+					changed - done;
+			if (first + run > inWords) {
+				first = inWords - run;
+			}
+			for (w = first; w < first + run; ++w) {
+				in[w] = (uint32_t)rand() << 16 ^ (uint32_t)rand();
+			}
+			modMapIncrMark(&markInc, first, run);
+			done += run;
+		}
+
+		t0 = nowNs();
+		modMapRun(&ctx, in, fullOut, inWords);
+		fullNs[f] = nowNs() - t0;
+
+		t0 = nowNs();
+		modMapIncrDiff(&diffInc, in);
+		modMapIncrRun(&diffInc, in, diffOut, NULL, 0);
+		diffNs[f] = nowNs() - t0;
+
+		t0 = nowNs();
+		modMapIncrRun(&markInc, in, markOut, devBuf, devWords);
+		markNs[f] = nowNs() - t0;
+
+		if (memcmp(diffOut, fullOut, outWords * sizeof(uint32_t)) != 0 ||
+				memcmp(markOut, fullOut, outWords * sizeof(uint32_t)) != 0) {
+			printf("incremental output differs from the full mapping at "
+					"frame %d\n", f);
+			return 1;
+		}
+		if (memcmp(devBuf, fullOut, devWords * sizeof(uint32_t)) != 0) {
+			printf("device buffer differs from the full mapping at frame "
+					"%d\n", f);
+			return 1;
+		}
+	}
+
+	snprintf(config, sizeof(config), "inWords=%zu blockWords=%zu "
+			"changePct=%g runWords=%zu bits=%u", inWords, blockWords,
+			changePct, runWords, cfg.bitsPerSym);
+	benchResultWrite("modMapFull", config, fullNs, frames);
+	benchResultWrite("modMapIncr.diff", config, diffNs, frames);
+	benchResultWrite("modMapIncr.mark", config, markNs, frames);
+
+	printf("\n%zu input words, %zu word blocks, %.1f%% changed per frame in "
+			"runs of %zu words, %d frames\n\n", inWords, blockWords,
+			changePct, runWords, frames);
+	printf("full   %10llu nsec/frame\n",
+			(unsigned long long)median(fullNs, frames));
+	printf("diff   %10llu nsec/frame  ",
+			(unsigned long long)median(diffNs, frames));
+	modMapIncrReport(&diffInc, stdout);
+	printf("mark   %10llu nsec/frame  ",
+			(unsigned long long)median(markNs, frames));
+	modMapIncrReport(&markInc, stdout);
+
+	modMapIncrFree(&diffInc);
+	modMapIncrFree(&markInc);
+	free(in);
+	free(fullOut);
+	free(diffOut);
+	free(markOut);
+	free(devBuf);
+	free(fullNs);
+	free(diffNs);
+	free(markNs);
+	return 0;
+}
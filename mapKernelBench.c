@@ -0,0 +1,133 @@
+/*****************************************************************************
+ *
+ * mapKernelBench.c
+ *
+ * Compares the generic modMapRun frame kernel with the specialized kernels
+ * of modMapKernels.h for every modulation and frame size that has one.
+ *
+ * 		mapKernelBench [-r rotPeriod] [-g gain] [-n repeats]
+ *
+ * Each kernel maps the same random frame repeat times with a warm cache,
+ * the median nsec per symbol of both kernels is printed with the speedup
+ * and the outputs are checked to be identical.  The per-frame times of
+ * the specialized kernels are stored as modMapKernel.<bits>.<words>.  A
+ * zero rotPeriod measures the kernels without the phase ramp.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include "modMapKernels.h"
+#include "benchResults.h"
+
+#define DEF_REPEATS				2000
+#define MAX_IN_WORDS			256
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// median nsec per frame of repeat runs of one kernel
+static uint64_t timeKernel(modMapKernel_t run, const modMapCtx_t* ctx,
+		const uint32_t* in, uint32_t* out, size_t inWords, uint64_t* samples,
+		int repeats)
+{
+	uint64_t t0;
+	int r;
+	for (r = 0; r < repeats; ++r) {
+		t0 = nowNs();
+		run(ctx, in, out, inWords);
+		samples[r] = nowNs() - t0;
+	}
+	qsort(samples, repeats, sizeof(uint64_t), benchCompareU64);
+	return samples[repeats / 2];
+}
+
+int main(int argc, char* argv[])
+{
+	static const uint32_t bitsList[] = { 1, 2, 4, 8 };
+	static const size_t sizeList[] = { 16, 64, 256 };
+	static uint32_t in[MAX_IN_WORDS];
+	static uint32_t outGeneric[MAX_IN_WORDS * 32];
+	static uint32_t outSpecial[MAX_IN_WORDS * 32];
+	modMapCfg_t cfg = { 2, 0.9, 64 };
+	modMapCtx_t ctx;
+	uint64_t* samples;
+	int repeats = DEF_REPEATS, opt;
+	unsigned b, s;
+	size_t w;
+
+	while ((opt = getopt(argc, argv, "r:g:n:h")) != -1) {
+		switch (opt) {
+		case 'r': cfg.rotPeriod = strtoul(optarg, NULL, 0); break;
+		case 'g': cfg.gain = atof(optarg); break;
+		case 'n': repeats = atoi(optarg); break;
+		default:
+			repeats = 0;
+			break;
+		}
+	}
+	if (repeats <= 0 || !modMapCfgValid(&cfg)) {
+		printf("usage: %s [-r rotPeriod] [-g gain] [-n repeats]\n", argv[0]);
+		return 1;
+	}
+	samples = calloc(repeats, sizeof(uint64_t));
+	if (samples == NULL) {
+		printf("cannot allocate the sample buffer\n");
+		return 1;
+	}
+	srand(1);
+	for (w = 0; w < MAX_IN_WORDS; ++w) {
+		in[w] = (uint32_t)rand() << 16 ^ (uint32_t)rand();
+	}
+
+	printf("\nrotPeriod %u, gain %g, %d repeats, median nsec per symbol\n\n",
+			cfg.rotPeriod, cfg.gain, repeats);
+	printf("%5s %6s %10s %10s %8s\n", "bits", "words", "generic",
+			"special", "speedup");
+	for (b = 0; b < sizeof(bitsList) / sizeof(bitsList[0]); ++b) {
+		cfg.bitsPerSym = bitsList[b];
+		modMapSetup(&ctx, &cfg);
+		for (s = 0; s < sizeof(sizeList) / sizeof(sizeList[0]); ++s) {
+			size_t words = sizeList[s];
+			size_t symbols = modMapOutWords(&cfg, words);
+			modMapKernel_t special = modMapLookup(&cfg, words);
+			uint64_t generic, fast;
+			char name[48], config[96];
+
+			if (special == NULL) {
+				continue;
+			}
+			generic = timeKernel(modMapRun, &ctx, in, outGeneric, words,
+					samples, repeats);
+			fast = timeKernel(special, &ctx, in, outSpecial, words, samples,
+					repeats);
+			if (memcmp(outGeneric, outSpecial,
+					symbols * sizeof(uint32_t)) != 0) {
+				printf("kernel %u bits %zu words differs from modMapRun\n",
+						cfg.bitsPerSym, words);
+				return 1;
+			}
+			snprintf(name, sizeof(name), "modMapKernel.%u.%zu",
+					cfg.bitsPerSym, words);
+			snprintf(config, sizeof(config), "rotPeriod=%u gain=%g",
+					cfg.rotPeriod, cfg.gain);
+			benchResultWrite(name, config, samples, repeats);
+			printf("%5u %6zu %10.2f %10.2f %7.2fx\n", cfg.bitsPerSym, words,
+					(double)generic / symbols, (double)fast / symbols,
+					fast ? (double)generic / fast : 0.0);
+		}
+	}
+	free(samples);
+	return 0;
+}
@@ -0,0 +1,357 @@
+/*****************************************************************************
+ *
+ * mapReplay.c
+ *
+ * Replays a recorded modulation input file through the modMap.h mapping
+ * kernels, at a real-time frame rate or as fast as possible, and reports
+ * the sustained frame rate and the latency of every frame.
+ *
+ * 		mapReplay -f file [-w inWords] [-b bitsPerSym] [-g gain]
+ * 				  [-r rotPeriod] [-R framesPerSec] [-q fracBits]
+ * 				  [-m mmap|read] [-W windowMiB] [-l loops] [-p rtPriority]
+ *
+ * The file is a sequence of frames of inWords 32-bit input words, a
+ * trailing partial frame is ignored.  In mmap mode the file is mapped
+ * read only with MADV_SEQUENTIAL, the next window is requested with
+ * MADV_WILLNEED while the current one is mapped and the window behind is
+ * dropped with MADV_DONTNEED, so a file larger than memory streams
+ * through.  In read mode frames are read into a buffer window by window,
+ * with POSIX_FADV_WILLNEED for the next window.  The window is rounded
+ * down to whole frames, at least one frame, and the first one is requested
+ * when the file is opened.  The madvise ranges are widened to whole pages
+ * on their own, except the dropped one stops short of the page the current
+ * window starts in.
+ *
+ * With -R each frame is released on an absolute CLOCK_MONOTONIC schedule
+ * and its latency is completion minus planned release, without it frames
+ * are mapped back to back and the latency is the time to fetch and map
+ * the frame, page faults included.  Frames are mapped by the specialized
+ * kernel for the frame size when there is one, or in fixed point with -q.
+ * The latencies are stored as mapReplay.<mode>.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include "modMapKernels.h"
+#include "modMapFixed.h"
+#include "phaseBudget.h"
+#include "benchResults.h"
+
+#define DEF_IN_WORDS			64
+#define DEF_WINDOW_MIB			8
+#define MAX_LAT_SAMPLES			BENCH_MAX_SAMPLES
+
+typedef struct {
+	int useMmap;
+	int fd;
+	const uint8_t* map;			// whole file in mmap mode
+	uint8_t* buf;				// one window in read mode
+	size_t fileBytes;
+	size_t frameBytes;
+	size_t pageBytes;
+	size_t windowBytes;
+	size_t winStart;			// file offset of the current window
+	size_t winBytes;			// bytes valid in the current window
+} replaySrc_t;
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// madvise the mapped bytes from start to end, widened to whole pages
+static void srcAdvise(replaySrc_t* src, size_t start, size_t end,
+		int advice)
+{
+	size_t mask = src->pageBytes - 1;
+
+	start &= ~mask;
+	end = (end + mask) & ~mask;
+	if (end > start) {
+		madvise((void*)(src->map + start), end - start, advice);
+	}
+}
+
+static int srcOpen(replaySrc_t* src, const char* path, size_t frameBytes,
+		size_t windowBytes)
+{
+	struct stat st;
+
+	src->fd = open(path, O_RDONLY);
+	if (src->fd == -1 || fstat(src->fd, &st) == -1) {
+		printf("cannot open input file %s\n", path);
+		return -1;
+	}
+	src->fileBytes = (size_t)st.st_size / frameBytes * frameBytes;
+	src->frameBytes = frameBytes;
+	src->pageBytes = sysconf(_SC_PAGESIZE);
+	// whole frames per window, at least one frame
+	src->windowBytes = windowBytes / frameBytes * frameBytes;
+	if (src->windowBytes == 0) {
+		src->windowBytes = frameBytes;
+	}
+	if (src->fileBytes == 0) {
+		printf("%s holds no complete frame\n", path);
+		return -1;
+	}
+	if (src->useMmap) {
+		src->map = mmap(NULL, src->fileBytes, PROT_READ, MAP_PRIVATE,
+				src->fd, 0);
+		if (src->map == MAP_FAILED) {
+			printf("cannot map %s\n", path);
+			return -1;
+		}
+		madvise((void*)src->map, src->fileBytes, MADV_SEQUENTIAL);
+		// srcWindow hints the window after the one it moves to
+		srcAdvise(src, 0, (src->windowBytes < src->fileBytes) ?
+				src->windowBytes : src->fileBytes, MADV_WILLNEED);
+	}
+	else {
+		src->buf = malloc(src->windowBytes);
+		if (src->buf == NULL) {
+			printf("cannot allocate the read window\n");
+			return -1;
+		}
+		posix_fadvise(src->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+		posix_fadvise(src->fd, 0, src->windowBytes, POSIX_FADV_WILLNEED);
+	}
+	src->winStart = 0;
+	src->winBytes = 0;
+	return 0;
+}
+
+static void srcClose(replaySrc_t* src)
+{
+	if (src->useMmap && src->map != NULL && src->map != MAP_FAILED) {
+		munmap((void*)src->map, src->fileBytes);
+	}
+	free(src->buf);
+	if (src->fd != -1) {
+		close(src->fd);
+	}
+}
+
+// move the window to start at offset, hinting the one after it
+static int srcWindow(replaySrc_t* src, size_t offset)
+{
+	size_t next = offset + src->windowBytes;
+	size_t len = (next <= src->fileBytes) ? src->windowBytes :
+			src->fileBytes - offset;
+
+	if (src->useMmap) {
+		// keep the page the current window starts in
+		if (offset >= src->windowBytes) {
+			srcAdvise(src, offset - src->windowBytes,
+					offset & ~(src->pageBytes - 1), MADV_DONTNEED);
+		}
+		if (next < src->fileBytes) {
+			srcAdvise(src, next, (next + src->windowBytes <=
+					src->fileBytes) ? next + src->windowBytes :
+					src->fileBytes, MADV_WILLNEED);
+		}
+	}
+	else {
+		size_t done = 0;
+		if (next < src->fileBytes) {
+			posix_fadvise(src->fd, next, src->windowBytes,
+					POSIX_FADV_WILLNEED);
+		}
+		while (done < len) {
+			ssize_t n = pread(src->fd, src->buf + done, len - done,
+					offset + done);
+			if (n <= 0) {
+				printf("short read at offset %zu\n", offset + done);
+				return -1;
+			}
+			done += n;
+		}
+	}
+	src->winStart = offset;
+	src->winBytes = len;
+	return 0;
+}
+
+// frame at file offset, inside the current window
+static const uint32_t* srcFrame(replaySrc_t* src, size_t offset)
+{
+	if (offset >= src->winStart + src->winBytes || offset < src->winStart) {
+		if (srcWindow(src, offset) != 0) {
+			return NULL;
+		}
+	}
+	return (const uint32_t*)(src->useMmap ? src->map + offset :
+			src->buf + (offset - src->winStart));
+}
+
+static long majorFaults(void)
+{
+	struct rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	return ru.ru_majflt;
+}
+
+int main(int argc, char* argv[])
+{
+	modMapCfg_t cfg = { 2, 0.9, 64 };
+	modMapCtx_t ctx;
+	modMapFixedCtx_t fx;
+	replaySrc_t src;
+	phaseHist_t latency;
+	struct sched_param my_params;
+	struct timespec next;
+	const char* path = NULL;
+	const char* mode = "mmap";
+	size_t inWords = DEF_IN_WORDS, windowMiB = DEF_WINDOW_MIB, offset;
+	int fps = 0, fracBits = 0, loops = 1, rtPriority = 0, loop, opt;
+	uint64_t* samples;
+	uint64_t frames = 0, late = 0, planned = 0, start, end, t0, elapsed;
+	uint32_t numSamples = 0;
+	uint32_t* out;
+	long faults;
+	char name[32], config[160];
+
+	while ((opt = getopt(argc, argv, "f:w:b:g:r:R:q:m:W:l:p:h")) != -1) {
+		switch (opt) {
+		case 'f': path = optarg; break;
+		case 'w': inWords = strtoul(optarg, NULL, 0); break;
+		case 'b': cfg.bitsPerSym = strtoul(optarg, NULL, 0); break;
+		case 'g': cfg.gain = atof(optarg); break;
+		case 'r': cfg.rotPeriod = strtoul(optarg, NULL, 0); break;
+		case 'R': fps = atoi(optarg); break;
+		case 'q': fracBits = atoi(optarg); break;
+		case 'm': mode = optarg; break;
+		case 'W': windowMiB = strtoul(optarg, NULL, 0); break;
+		case 'l': loops = atoi(optarg); break;
+		case 'p': rtPriority = atoi(optarg); break;
+		default:
+			path = NULL;
+			break;
+		}
+	}
+	if (path == NULL || inWords == 0 || fps < 0 || loops <= 0 ||
+			windowMiB == 0 || !modMapCfgValid(&cfg) ||
+			(strcmp(mode, "mmap") != 0 && strcmp(mode, "read") != 0)) {
+		printf("usage: %s -f file [-w inWords] [-b bitsPerSym] [-g gain] "
+				"[-r rotPeriod] [-R framesPerSec] [-q fracBits] "
+				"[-m mmap|read] [-W windowMiB] [-l loops] [-p rtPriority]\n",
+				argv[0]);
+		return 1;
+	}
+
+	modMapSetup(&ctx, &cfg);
+	modMapSpecialize(&ctx, inWords);
+	if (fracBits != 0 && modMapFixedSetup(&fx, &ctx, fracBits) != 0) {
+		printf("unsupported fixed-point precision Q%d\n", fracBits);
+		return 1;
+	}
+	memset(&src, 0, sizeof(src));
+	src.fd = -1;
+	src.useMmap = (strcmp(mode, "mmap") == 0);
+	out = malloc(modMapOutWords(&cfg, inWords) * sizeof(uint32_t));
+	samples = calloc(MAX_LAT_SAMPLES, sizeof(uint64_t));
+	if (out == NULL || samples == NULL || srcOpen(&src, path,
+			inWords * sizeof(uint32_t), windowMiB * 1024 * 1024) != 0) {
+		srcClose(&src);
+		return 1;
+	}
+	if (rtPriority > 0) {
+		my_params.sched_priority = rtPriority;
+		if (sched_setscheduler(0, SCHED_FIFO, &my_params) == -1) {
+			printf("could not change scheduler policy\n");
+		}
+		// the output and samples only, the input streams through
+		mlock(out, modMapOutWords(&cfg, inWords) * sizeof(uint32_t));
+		mlock(samples, MAX_LAT_SAMPLES * sizeof(uint64_t));
+	}
+	memset(&latency, 0, sizeof(latency));
+
+	printf("\n%zu frames of %zu words, %s, %s kernel, %s\n\n",
+			src.fileBytes / src.frameBytes, inWords, mode,
+			fracBits ? "fixed-point" : (ctx.run != modMapRun) ?
+					"specialized" : "generic",
+			fps ? "real time" : "as fast as possible");
+	faults = majorFaults();
+	t0 = nowNs();
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	for (loop = 0; loop < loops; ++loop) {
+		for (offset = 0; offset < src.fileBytes; offset += src.frameBytes) {
+			const uint32_t* in;
+			if (fps) {
+				next.tv_nsec += 1000000000L / fps;
+				while (next.tv_nsec >= 1000000000L) {
+					next.tv_nsec -= 1000000000L;
+					next.tv_sec++;
+				}
+				clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+				planned = (uint64_t)next.tv_sec * 1000000000ULL + next.tv_nsec;
+			}
+			start = nowNs();
+			in = srcFrame(&src, offset);
+			if (in == NULL) {
+				loop = loops;
+				break;
+			}
+			if (fracBits) {
+				modMapFixedRun(&fx, in, out, inWords);
+			}
+			else {
+				modMapKernelFor(&ctx, inWords)(&ctx, in, out, inWords);
+			}
+			end = nowNs();
+
+			end -= fps ? planned : start;
+			phaseHistAdd(&latency, end);
+			if (numSamples < MAX_LAT_SAMPLES) {
+				samples[numSamples++] = end;
+			}
+			// a late frame moves the schedule instead of bunching up
+			if (fps && end > 1000000000ULL / fps) {
+				late++;
+				clock_gettime(CLOCK_MONOTONIC, &next);
+			}
+			frames++;
+		}
+	}
+	elapsed = nowNs() - t0;
+	faults = majorFaults() - faults;
+
+	printf("%llu frames in %.3f sec, %.0f frames/sec, %.1f MB/sec input, "
+			"%ld major faults\n", (unsigned long long)frames, elapsed / 1e9,
+			elapsed ? frames * 1e9 / elapsed : 0.0,
+			elapsed ? frames * src.frameBytes * 1e3 / elapsed : 0.0, faults);
+	printf("%s latency (usec): p50 %.1f p99 %.1f max %.1f",
+			fps ? "release to completion" : "fetch and map",
+			phaseHistPercentile(&latency, 50) / 1e3,
+			phaseHistPercentile(&latency, 99) / 1e3, latency.maxNs / 1e3);
+	if (fps) {
+		printf(", %llu late frames", (unsigned long long)late);
+	}
+	printf("\n");
+
+	snprintf(name, sizeof(name), "mapReplay.%s", mode);
+	snprintf(config, sizeof(config), "inWords=%zu bits=%u rotPeriod=%u "
+			"fps=%d fracBits=%d windowMiB=%zu priority=%d", inWords,
+			cfg.bitsPerSym, cfg.rotPeriod, fps, fracBits, windowMiB,
+			rtPriority);
+	benchResultWrite(name, config, samples, numSamples);
+
+	srcClose(&src);
+	free(out);
+	free(samples);
+	return 0;
+}
@@ -0,0 +1,278 @@
+/*****************************************************************************
+ *
+ * memHierarchyProfile.c
+ *
+ * Memory hierarchy profiler used to size the mapping buffers (modBuff in
+ * pthrdsThreeThrdsHWMapP9.c, the buffer in rtPrioTests.c).
+ *
+ * For working sets from 4 KiB up to the maximum given (256 MiB by default)
+ * it measures:
+ *
+ * 		1.	load to use latency, by chasing pointers through a random
+ * 			cyclic permutation of cache lines, so neither the prefetcher
+ * 			nor out of order execution can hide the latency.
+ * 		2.	streaming read and write bandwidth.
+ *
+ * A cache level boundary is reported wherever the latency steps up by more
+ * than half between consecutive sizes, and the detected sizes are printed
+ * next to those the kernel reports in sysfs.  From those the tool
+ * recommends the largest mapping working set that stays in L2 and a chunk
+ * size for calcModAndMapBits that stays in L1, and reports where a buffer
+ * of the given size (-b, in bytes) lands.
+ *
+ * 		memHierarchyProfile [-m maxMiB] [-b bufferBytes]
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#define CACHE_LINE				64			// bytes per cache line
+#define MIN_SET					(4 * 1024)
+#define DEF_MAX_MIB				256
+#define CHASE_STEPS				(4 * 1024 * 1024)
+#define STREAM_BYTES			(512ULL * 1024 * 1024)	// bytes per stream test
+#define MAX_SIZES				64
+#define MAX_LEVELS				4
+#define STEP_RATIO				1.5			// latency jump marking a level
+
+typedef struct {
+	size_t bytes;
+	double latencyNs;
+	double readMBs;
+	double writeMBs;
+} sizeResult_t;
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// link the cache lines of buf into one random cycle (Sattolo's algorithm)
+// so every line is visited once per lap in unpredictable order, order is
+// scratch space for one index per line
+static void buildChase(uint8_t* buf, size_t bytes, size_t* order)
+{
+	size_t lines = bytes / CACHE_LINE;
+	size_t i, j, tmp;
+
+	for (i = 0; i < lines; ++i) {
+		order[i] = i;
+	}
+	for (i = lines - 1; i > 0; --i) {
+		j = (size_t)(((uint64_t)rand() << 31 ^ rand()) % i);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+	for (i = 0; i < lines; ++i) {
+		*(void**)(buf + order[i] * CACHE_LINE) =
+				buf + order[(i + 1) % lines] * CACHE_LINE;
+	}
+}
+
+static double chaseLatency(uint8_t* buf, size_t bytes, size_t* order)
+{
+	void** p = (void**)buf;
+	uint64_t start;
+	int i;
+
+	buildChase(buf, bytes, order);
+	// one lap to warm the caches and TLB
+	for (i = 0; i < (int)(bytes / CACHE_LINE); ++i) {
+		p = (void**)*p;
+	}
+	start = nowNs();
+	for (i = 0; i < CHASE_STEPS; i += 4) {
+		p = (void**)*p;
+		p = (void**)*p;
+		p = (void**)*p;
+		p = (void**)*p;
+	}
+	__asm__ __volatile__("" : : "r"(p));
+	return (double)(nowNs() - start) / CHASE_STEPS;
+}
+
+static double readBandwidth(uint8_t* buf, size_t bytes)
+{
+	const uint64_t* p = (const uint64_t*)buf;
+	size_t words = bytes / sizeof(uint64_t);
+	uint64_t laps = STREAM_BYTES / bytes + 1;
+	uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+	uint64_t start, l;
+	size_t i;
+
+	start = nowNs();
+	for (l = 0; l < laps; ++l) {
+		for (i = 0; i < words; i += 4) {
+			s0 += p[i];
+			s1 += p[i + 1];
+			s2 += p[i + 2];
+			s3 += p[i + 3];
+		}
+		__asm__ __volatile__("" : : "r"(s0), "r"(s1), "r"(s2), "r"(s3));
+	}
+	return (double)bytes * laps * 1e3 / (double)(nowNs() - start);
+}
+
+static double writeBandwidth(uint8_t* buf, size_t bytes)
+{
+	uint64_t laps = STREAM_BYTES / bytes + 1;
+	uint64_t start, l;
+
+	start = nowNs();
+	for (l = 0; l < laps; ++l) {
+		memset(buf, (int)l, bytes);
+		__asm__ __volatile__("" : : "r"(buf) : "memory");
+	}
+	return (double)bytes * laps * 1e3 / (double)(nowNs() - start);
+}
+
+// print the data and unified cache sizes the kernel reports for cpu0
+static void printSysfsCaches(void)
+{
+	char path[128], type[32], size[32];
+	int level, idx;
+	FILE* f;
+
+	printf("\nkernel reported caches (cpu0):");
+	for (idx = 0; idx < 8; ++idx) {
+		snprintf(path, sizeof(path),
+				"/sys/devices/system/cpu/cpu0/cache/index%d/type", idx);
+		if ((f = fopen(path, "r")) == NULL) {
+			break;
+		}
+		if (fscanf(f, "%31s", type) != 1) {
+			type[0] = '\0';
+		}
+		fclose(f);
+		snprintf(path, sizeof(path),
+				"/sys/devices/system/cpu/cpu0/cache/index%d/level", idx);
+		if ((f = fopen(path, "r")) == NULL || fscanf(f, "%d", &level) != 1) {
+			level = 0;
+		}
+		if (f != NULL) {
+			fclose(f);
+		}
+		snprintf(path, sizeof(path),
+				"/sys/devices/system/cpu/cpu0/cache/index%d/size", idx);
+		if ((f = fopen(path, "r")) == NULL || fscanf(f, "%31s", size) != 1) {
+			strcpy(size, "?");
+		}
+		if (f != NULL) {
+			fclose(f);
+		}
+		if (strcmp(type, "Instruction") != 0) {
+			printf("  L%d %s", level, size);
+		}
+	}
+	printf("%s\n", idx == 0 ? "  none" : "");
+}
+
+int main(int argc, char* argv[])
+{
+	sizeResult_t results[MAX_SIZES];
+	size_t levels[MAX_LEVELS];
+	size_t maxBytes = (size_t)DEF_MAX_MIB * 1024 * 1024;
+	size_t bufferBytes = 0;
+	size_t bytes;
+	uint8_t* buf;
+	size_t* order;
+	int numSizes = 0;
+	int numLevels = 0;
+	int opt;
+	int i;
+
+	while ((opt = getopt(argc, argv, "m:b:h")) != -1) {
+		switch (opt) {
+		case 'm': maxBytes = (size_t)atoi(optarg) * 1024 * 1024; break;
+		case 'b': bufferBytes = strtoul(optarg, NULL, 0); break;
+		default:
+			printf("usage: %s [-m maxMiB] [-b bufferBytes]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (maxBytes < MIN_SET) {
+		maxBytes = MIN_SET;
+	}
+
+	buf = mmap(NULL, maxBytes, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (buf == MAP_FAILED) {
+		printf("ERROR: cannot allocate %zu bytes\n", maxBytes);
+		return 1;
+	}
+	order = malloc((maxBytes / CACHE_LINE) * sizeof(size_t));
+	if (order == NULL) {
+		printf("ERROR: cannot allocate the chase order\n");
+		munmap(buf, maxBytes);
+		return 1;
+	}
+	memset(buf, 1, maxBytes);
+	srand(1);
+
+	printf("\n%12s %12s %14s %14s\n", "working set", "latency ns",
+			"read MB/s", "write MB/s");
+	// two points per octave, 4 KiB, 6 KiB, 8 KiB, 12 KiB, ...
+	for (bytes = MIN_SET; bytes <= maxBytes && numSizes < MAX_SIZES;
+			bytes = (numSizes & 1) ? (bytes * 3) / 2 : (bytes / 3) * 4) {
+		sizeResult_t* r = &results[numSizes++];
+		r->bytes = bytes;
+		r->latencyNs = chaseLatency(buf, bytes, order);
+		r->readMBs = readBandwidth(buf, bytes);
+		r->writeMBs = writeBandwidth(buf, bytes);
+		printf("%9zu KiB %12.2f %14.0f %14.0f\n", bytes / 1024,
+				r->latencyNs, r->readMBs, r->writeMBs);
+	}
+
+	// the last size before each latency step is the capacity of a level
+	for (i = 1; i < numSizes && numLevels < MAX_LEVELS; ++i) {
+		if (results[i].latencyNs > results[i - 1].latencyNs * STEP_RATIO) {
+			levels[numLevels++] = results[i - 1].bytes;
+		}
+	}
+	printSysfsCaches();
+	printf("detected levels:");
+	for (i = 0; i < numLevels; ++i) {
+		printf("  L%d ~%zu KiB", i + 1, levels[i] / 1024);
+	}
+	printf("%s\n", numLevels ? "" : "  none");
+
+	if (numLevels >= 2) {
+		printf("\nrecommended mapping working set: <= %zu KiB (fits L2)\n",
+				levels[1] / 1024);
+	}
+	if (numLevels >= 1) {
+		printf("recommended calcModAndMapBits chunk: <= %zu KiB "
+				"(half of L1, leaves room for tables)\n", levels[0] / 2048);
+	}
+	if (bufferBytes > 0) {
+		int level = numLevels + 1;
+		for (i = numLevels - 1; i >= 0; --i) {
+			if (bufferBytes <= levels[i]) {
+				level = i + 1;
+			}
+		}
+		if (level > numLevels) {
+			printf("a %zu byte buffer does not fit in any cache level\n",
+					bufferBytes);
+		}
+		else {
+			printf("a %zu byte buffer fits in L%d\n", bufferBytes, level);
+		}
+	}
+
+	free(order);
+	munmap(buf, maxBytes);
+	return 0;
+}
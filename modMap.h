@@ -0,0 +1,226 @@
+/*****************************************************************************
+ *
+ * modMap.h
+ *
+ * Modulation and mapping kernel modelled on calcModAndMapBits, for the
+ * benchmarks and for hosts without hardwareMapSoC.h.
+ *
+ * Every input word is split into symbols of bitsPerSym bits, 1 (BPSK),
+ * 2 (QPSK), 4 (16QAM) or 8 (256QAM), least significant symbol first.  A
+ * symbol is Gray mapped onto its constellation, normalised to a peak
+ * amplitude of one and scaled by the gain, rotated by a phase ramp of one
+ * turn every rotPeriod symbols (a frequency shift, zero for none) and
+ * written as one 32-bit output word, I in the upper and Q in the lower
+ * half, both signed Q15, the layout of the FPGA RAM sample buffer.  The
+ * ramp restarts with every frame, so a frame maps to the same words
+ * however frames are grouped.
+ *
+ * modMapSetup builds the scaled constellation and the ramp table, which is
+ * most of the work for a short frame.  modMapFrame is the one frame entry
+ * and pays the setup on every call like calcModAndMapBits does,
+ * modMapBatch maps K frames into K destination buffers after one setup,
+ * and prefetches the next frame while mapping the current one.  Keep a
+ * context between batches of the same configuration with modMapFrames,
+ * which maps through the context's kernel, the generic modMapRun unless
+ * modMapKernels.h has specialized it.  A specialized kernel only handles
+ * the frame size it was chosen for, frames of any other size go through
+ * modMapRun.
+ *
+ * 		modMapCtx_t ctx;
+ * 		modMapCfg_t cfg = { 2, 0.9, 64 };		QPSK, gain 0.9
+ * 		modMapBatch(&ctx, &cfg, inFrames, outFrames, inWords, K);
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef MOD_MAP_H
+#define MOD_MAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+#define MOD_MAP_MAX_BITS		8			// bits per symbol, 256QAM
+#define MOD_MAP_MAX_ROT			1024		// phase ramp table entries
+#define MOD_MAP_Q15_ONE			32767.0
+
+typedef struct {
+	uint32_t bitsPerSym;		// 1, 2, 4 or 8
+	double gain;				// peak output amplitude, 0 to 1
+	uint32_t rotPeriod;			// symbols per ramp turn, power of two, or 0
+} modMapCfg_t;
+
+struct modMapCtx;
+typedef void (*modMapKernel_t)(const struct modMapCtx* ctx, const uint32_t* in,
+		uint32_t* out, size_t inWords);
+
+typedef struct modMapCtx {
+	modMapCfg_t cfg;
+	modMapKernel_t run;			// frame kernel, modMapRun by default
+	size_t runWords;			// frame size run is fixed to, 0 for any
+	uint32_t rotMask;			// rotPeriod - 1, zero without a ramp
+	double point[1 << MOD_MAP_MAX_BITS][2];	// scaled I, Q per symbol value
+	double rot[MOD_MAP_MAX_ROT][2];			// cos, sin of the ramp
+} modMapCtx_t;
+
+// output symbols for inWords input words
+static inline size_t modMapOutWords(const modMapCfg_t* cfg, size_t inWords)
+{
+	return inWords * (32 / cfg->bitsPerSym);
+}
+
+static inline int modMapCfgValid(const modMapCfg_t* cfg)
+{
+	uint32_t b = cfg->bitsPerSym;
+	return (b == 1 || b == 2 || b == 4 || b == 8) &&
+			cfg->gain >= 0.0 && cfg->gain <= 1.0 &&
+			cfg->rotPeriod <= MOD_MAP_MAX_ROT &&
+			(cfg->rotPeriod & (cfg->rotPeriod - 1)) == 0;
+}
+
+// round and saturate to Q15, pack I high and Q low
+static inline uint32_t modMapPack(double i, double q)
+{
+	long qi = lrint(i * MOD_MAP_Q15_ONE);
+	long qq = lrint(q * MOD_MAP_Q15_ONE);
+	qi = (qi > 32767) ? 32767 : (qi < -32768) ? -32768 : qi;
+	qq = (qq > 32767) ? 32767 : (qq < -32768) ? -32768 : qq;
+	return ((uint32_t)(uint16_t)qi << 16) | (uint16_t)qq;
+}
+
+static inline uint32_t modMapGrayToBin(uint32_t g)
+{
+	uint32_t b = g;
+	while (g >>= 1) {
+		b ^= g;
+	}
+	return b;
+}
+
+// amplitude level of m Gray coded bits on one axis, -(2^m - 1) to 2^m - 1
+static inline double modMapLevel(uint32_t bits, uint32_t m)
+{
+	return 2.0 * modMapGrayToBin(bits) - ((1u << m) - 1);
+}
+
+// map inWords words whose first symbol is symbol firstSym of the frame, so
+// part of a frame can be mapped with the ramp phase it has in the frame
+static inline void modMapRunAt(const modMapCtx_t* ctx, const uint32_t* in,
+		uint32_t* out, size_t inWords, uint32_t firstSym)
+{
+	uint32_t b = ctx->cfg.bitsPerSym;
+	uint32_t symMask = (1u << b) - 1;
+	uint32_t n = firstSym;
+	size_t w;
+	int shift;
+
+	for (w = 0; w < inWords; ++w) {
+		uint32_t word = in[w];
+		for (shift = 0; shift < 32; shift += b, ++n) {
+			const double* p = ctx->point[(word >> shift) & symMask];
+			const double* r = ctx->rot[n & ctx->rotMask];
+			*out++ = modMapPack(p[0] * r[0] - p[1] * r[1],
+					p[0] * r[1] + p[1] * r[0]);
+		}
+	}
+}
+
+// map one frame with a context already set up
+static inline void modMapRun(const modMapCtx_t* ctx, const uint32_t* in,
+		uint32_t* out, size_t inWords)
+{
+	modMapRunAt(ctx, in, out, inWords, 0);
+}
+
+// build the constellation and ramp tables for cfg, returns -1 when the
+// configuration is not supported
+static inline int modMapSetup(modMapCtx_t* ctx, const modMapCfg_t* cfg)
+{
+	uint32_t b = cfg->bitsPerSym, m = b / 2, s;
+	double peak;
+
+	if (!modMapCfgValid(cfg)) {
+		return -1;
+	}
+	ctx->cfg = *cfg;
+	ctx->run = modMapRun;
+	ctx->runWords = 0;
+	// square QAM with m bits per axis, I from the upper bits, BPSK on I
+	peak = (b == 1) ? 1.0 : sqrt(2.0) * ((1u << m) - 1);
+	for (s = 0; s < (1u << b); ++s) {
+		if (b == 1) {
+			ctx->point[s][0] = s ? -1.0 : 1.0;
+			ctx->point[s][1] = 0.0;
+		}
+		else {
+			ctx->point[s][0] = modMapLevel(s >> m, m) / peak;
+			ctx->point[s][1] = modMapLevel(s & ((1u << m) - 1), m) / peak;
+		}
+		ctx->point[s][0] *= cfg->gain;
+		ctx->point[s][1] *= cfg->gain;
+	}
+	ctx->rotMask = cfg->rotPeriod ? cfg->rotPeriod - 1 : 0;
+	ctx->rot[0][0] = 1.0;
+	ctx->rot[0][1] = 0.0;
+	for (s = 1; s < cfg->rotPeriod; ++s) {
+		ctx->rot[s][0] = cos(2.0 * M_PI * s / cfg->rotPeriod);
+		ctx->rot[s][1] = sin(2.0 * M_PI * s / cfg->rotPeriod);
+	}
+	return 0;
+}
+
+// one frame, the setup is paid on every call
+static inline int modMapFrame(modMapCtx_t* ctx, const modMapCfg_t* cfg,
+		const uint32_t* in, uint32_t* out, size_t inWords)
+{
+	if (modMapSetup(ctx, cfg) != 0) {
+		return -1;
+	}
+	modMapRun(ctx, in, out, inWords);
+	return 0;
+}
+
+// the context's kernel for frames of inWords, modMapRun when the kernel
+// is specialized for another frame size
+static inline modMapKernel_t modMapKernelFor(const modMapCtx_t* ctx,
+		size_t inWords)
+{
+	return (ctx->runWords == 0 || ctx->runWords == inWords) ? ctx->run :
+			modMapRun;
+}
+
+// k frames with a context already set up, the next input frame is pulled
+// into the cache while the current one is mapped
+static inline void modMapFrames(const modMapCtx_t* ctx,
+		const uint32_t* const* in, uint32_t* const* out, size_t inWords,
+		uint32_t k)
+{
+	modMapKernel_t run = modMapKernelFor(ctx, inWords);
+	uint32_t f;
+	size_t w;
+
+	for (f = 0; f < k; ++f) {
+		if (f + 1 < k) {
+			for (w = 0; w < inWords; w += 64 / sizeof(uint32_t)) {
+				__builtin_prefetch(&in[f + 1][w], 0, 3);
+			}
+		}
+		run(ctx, in[f], out[f], inWords);
+	}
+}
+
+// k frames after a single setup, e.g. a backlog after an overrun
+static inline int modMapBatch(modMapCtx_t* ctx, const modMapCfg_t* cfg,
+		const uint32_t* const* in, uint32_t* const* out, size_t inWords,
+		uint32_t k)
+{
+	if (modMapSetup(ctx, cfg) != 0) {
+		return -1;
+	}
+	modMapFrames(ctx, in, out, inWords, k);
+	return 0;
+}
+
+#endif // MOD_MAP_H
@@ -0,0 +1,201 @@
+/*****************************************************************************
+ *
+ * modMapFixed.h
+ *
+ * Fixed-point version of the modMap.h mapping, for targets such as the
+ * Cortex-A9 whose double precision throughput is weak.  The output words
+ * are the same Q15 I/Q pairs as the floating-point reference modMapRun.
+ *
+ * modMapFixedSetup quantizes the constellation and ramp tables of a set up
+ * modMap.h context to fracBits fractional bits, so both paths map the same
+ * constellation.  The constellation is scaled by 32767 / 32768 first, so
+ * the final shift to Q15 gives the MOD_MAP_Q15_ONE full scale of
+ * modMapPack rather than 32768, without it every component would carry a
+ * gain error of up to one LSB beyond the bound below.  Up to 15 fractional
+ * bits a symbol is mapped entirely in 32-bit integer arithmetic, a Q15 by
+ * Q15 product is Q30 and the sum of the two products of the rotation stays
+ * below 2^31 since the constellation and ramp magnitudes are at most one.
+ * From 16 up to 30 fractional bits (the Q31 path, 30 bits so the 64-bit
+ * sum cannot overflow) the products are 64-bit.  The result is rounded to
+ * nearest and saturated to Q15.
+ *
+ * Every table entry is off by at most half an LSB of its format, so with
+ * f fractional bits a rotated component is off by at most 2^(16 - f) Q15
+ * LSBs before the final rounding adds half an LSB, without the ramp the
+ * bound is 2^(14 - f) plus half an LSB.  modMapFixedBound returns it and
+ * modMapFixedError measures the actual error of a frame against the
+ * reference.
+ *
+ * 		modMapSetup(&ctx, &cfg);
+ * 		modMapFixedSetup(&fx, &ctx, 15);
+ * 		modMapFixedRun(&fx, in, out, inWords);
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef MOD_MAP_FIXED_H
+#define MOD_MAP_FIXED_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include "modMap.h"
+
+#define MOD_MAP_FIXED_MIN_FRAC	8
+#define MOD_MAP_FIXED_MAX_FRAC	30
+
+typedef struct {
+	modMapCfg_t cfg;
+	int fracBits;
+	uint32_t rotMask;
+	int32_t point[1 << MOD_MAP_MAX_BITS][2];	// I, Q in Q(fracBits)
+	int32_t rot[MOD_MAP_MAX_ROT][2];			// cos, sin in Q(fracBits)
+} modMapFixedCtx_t;
+
+// measured error of fixed against reference output, in Q15 LSBs
+typedef struct {
+	uint32_t maxAbs;
+	double rms;
+	uint64_t count;
+	uint64_t over;				// components beyond modMapFixedBound
+} modMapFixedErr_t;
+
+static inline int32_t modMapFixedQuant(double v, int fracBits)
+{
+	return (int32_t)llrint(ldexp(v, fracBits));
+}
+
+static inline uint32_t modMapFixedPack(int32_t i, int32_t q)
+{
+	i = (i > 32767) ? 32767 : (i < -32768) ? -32768 : i;
+	q = (q > 32767) ? 32767 : (q < -32768) ? -32768 : q;
+	return ((uint32_t)(uint16_t)i << 16) | (uint16_t)q;
+}
+
+// quantize the tables of a set up floating-point context, returns -1 for
+// an unsupported precision
+static inline int modMapFixedSetup(modMapFixedCtx_t* fx,
+		const modMapCtx_t* ref, int fracBits)
+{
+	// the final shift scales by 2^15, modMapPack by MOD_MAP_Q15_ONE
+	double scale = MOD_MAP_Q15_ONE / 32768.0;
+	uint32_t s;
+
+	if (fracBits < MOD_MAP_FIXED_MIN_FRAC ||
+			fracBits > MOD_MAP_FIXED_MAX_FRAC) {
+		return -1;
+	}
+	fx->cfg = ref->cfg;
+	fx->fracBits = fracBits;
+	fx->rotMask = ref->rotMask;
+	for (s = 0; s < (1u << ref->cfg.bitsPerSym); ++s) {
+		fx->point[s][0] = modMapFixedQuant(ref->point[s][0] * scale, fracBits);
+		fx->point[s][1] = modMapFixedQuant(ref->point[s][1] * scale, fracBits);
+	}
+	for (s = 0; s <= ref->rotMask; ++s) {
+		fx->rot[s][0] = modMapFixedQuant(ref->rot[s][0], fracBits);
+		fx->rot[s][1] = modMapFixedQuant(ref->rot[s][1], fracBits);
+	}
+	return 0;
+}
+
+// 32-bit path, fracBits up to 15
+static inline void modMapFixedRun32(const modMapFixedCtx_t* fx,
+		const uint32_t* in, uint32_t* out, size_t inWords)
+{
+	uint32_t b = fx->cfg.bitsPerSym;
+	uint32_t symMask = (1u << b) - 1;
+	int shiftOut = 2 * fx->fracBits - 15;
+	int32_t half = 1 << (shiftOut - 1);
+	uint32_t n = 0;
+	size_t w;
+	int shift;
+
+	for (w = 0; w < inWords; ++w) {
+		uint32_t word = in[w];
+		for (shift = 0; shift < 32; shift += b, ++n) {
+			const int32_t* p = fx->point[(word >> shift) & symMask];
+			const int32_t* r = fx->rot[n & fx->rotMask];
+			int32_t i = p[0] * r[0] - p[1] * r[1];
+			int32_t q = p[0] * r[1] + p[1] * r[0];
+			*out++ = modMapFixedPack((i + half) >> shiftOut,
+					(q + half) >> shiftOut);
+		}
+	}
+}
+
+// 64-bit path, any fracBits
+static inline void modMapFixedRun64(const modMapFixedCtx_t* fx,
+		const uint32_t* in, uint32_t* out, size_t inWords)
+{
+	uint32_t b = fx->cfg.bitsPerSym;
+	uint32_t symMask = (1u << b) - 1;
+	int shiftOut = 2 * fx->fracBits - 15;
+	int64_t half = 1LL << (shiftOut - 1);
+	uint32_t n = 0;
+	size_t w;
+	int shift;
+
+	for (w = 0; w < inWords; ++w) {
+		uint32_t word = in[w];
+		for (shift = 0; shift < 32; shift += b, ++n) {
+			const int32_t* p = fx->point[(word >> shift) & symMask];
+			const int32_t* r = fx->rot[n & fx->rotMask];
+			int64_t i = (int64_t)p[0] * r[0] - (int64_t)p[1] * r[1];
+			int64_t q = (int64_t)p[0] * r[1] + (int64_t)p[1] * r[0];
+			*out++ = modMapFixedPack((int32_t)((i + half) >> shiftOut),
+					(int32_t)((q + half) >> shiftOut));
+		}
+	}
+}
+
+static inline void modMapFixedRun(const modMapFixedCtx_t* fx,
+		const uint32_t* in, uint32_t* out, size_t inWords)
+{
+	if (fx->fracBits <= 15) {
+		modMapFixedRun32(fx, in, out, inWords);
+	}
+	else {
+		modMapFixedRun64(fx, in, out, inWords);
+	}
+}
+
+// worst case error in Q15 LSBs against the exact, unrounded mapping
+static inline double modMapFixedBound(const modMapFixedCtx_t* fx)
+{
+	int ramp = fx->rotMask != 0;
+	return ldexp(1.0, (ramp ? 16 : 14) - fx->fracBits) + 0.5;
+}
+
+// accumulate the error of a fixed-point frame against the reference output
+// of the same input, the reference itself is within half an LSB of exact
+static inline void modMapFixedError(modMapFixedErr_t* err,
+		const modMapFixedCtx_t* fx, const uint32_t* fixedOut,
+		const uint32_t* refOut, size_t symbols)
+{
+	double bound = modMapFixedBound(fx) + 0.5;
+	double sumSq = err->rms * err->rms * 2 * err->count;
+	size_t s;
+	int c;
+
+	for (s = 0; s < symbols; ++s) {
+		for (c = 0; c < 2; ++c) {
+			int shift = c ? 0 : 16;
+			int32_t d = (int16_t)(fixedOut[s] >> shift) -
+					(int16_t)(refOut[s] >> shift);
+			uint32_t a = (d < 0) ? -d : d;
+			if (a > err->maxAbs) {
+				err->maxAbs = a;
+			}
+			if (a > bound) {
+				err->over++;
+			}
+			sumSq += (double)d * d;
+		}
+	}
+	err->count += symbols;
+	err->rms = err->count ? sqrt(sumSq / (2 * err->count)) : 0.0;
+}
+
+#endif // MOD_MAP_FIXED_H
@@ -0,0 +1,179 @@
+/*****************************************************************************
+ *
+ * modMapIncr.h
+ *
+ * Incremental re-mapping for modMap.h, only the blocks of a frame whose
+ * input changed since the last cycle are mapped again and written out.
+ *
+ * The input frame is divided into blocks of blockWords words.  A block is
+ * marked dirty either by the producer, which knows what it wrote, with
+ * modMapIncrMark, or by modMapIncrDiff, which compares the frame with a
+ * shadow copy of the input as it was last mapped.  The compare is a plain
+ * read pass, far cheaper than mapping the block.  modMapIncrRun maps the
+ * dirty blocks with the ramp phase they have in the frame, so the output
+ * is the same as mapping the whole frame, copies their output words to the
+ * device buffer when one is given and clears the marks.  The first run
+ * and every run after modMapIncrInvalidate, e.g. after the context is set
+ * up again with a new configuration, map the whole frame, the output
+ * buffer must then be sized for the new bits per symbol.
+ *
+ * 		modMapIncrInit(&inc, &ctx, inWords, 16);
+ * 		modMapIncrDiff(&inc, in);			or modMapIncrMark per write
+ * 		modMapIncrRun(&inc, in, out, fpgaRamBufPtr(fpgaMem), devWords);
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef MOD_MAP_INCR_H
+#define MOD_MAP_INCR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "socRegMap.h"
+#include "modMap.h"
+
+#define MOD_MAP_INCR_DEF_BLOCK	16			// input words per block
+
+typedef struct {
+	const modMapCtx_t* ctx;
+	size_t inWords;
+	size_t blockWords;
+	size_t numBlocks;
+	uint32_t* shadow;			// input as last mapped, for modMapIncrDiff
+	uint64_t* dirty;			// one bit per block
+	int valid;					// output holds a complete mapping
+
+	// statistics
+	uint64_t frames;
+	uint64_t blocksMapped;
+	uint64_t blocksTotal;
+	uint64_t devWordsWritten;
+} modMapIncr_t;
+
+static inline int modMapIncrInit(modMapIncr_t* inc, const modMapCtx_t* ctx,
+		size_t inWords, size_t blockWords)
+{
+	memset(inc, 0, sizeof(*inc));
+	inc->ctx = ctx;
+	inc->inWords = inWords;
+	inc->blockWords = blockWords ? blockWords : MOD_MAP_INCR_DEF_BLOCK;
+	inc->numBlocks = (inWords + inc->blockWords - 1) / inc->blockWords;
+	inc->shadow = calloc(inWords, sizeof(uint32_t));
+	inc->dirty = calloc((inc->numBlocks + 63) / 64, sizeof(uint64_t));
+	if (inc->shadow == NULL || inc->dirty == NULL) {
+		printf("cannot allocate the incremental mapping state\n");
+		free(inc->shadow);
+		free(inc->dirty);
+		return -1;
+	}
+	return 0;
+}
+
+static inline void modMapIncrFree(modMapIncr_t* inc)
+{
+	free(inc->shadow);
+	free(inc->dirty);
+	inc->shadow = NULL;
+	inc->dirty = NULL;
+}
+
+// the next run maps the whole frame
+static inline void modMapIncrInvalidate(modMapIncr_t* inc)
+{
+	inc->valid = 0;
+}
+
+// the producer changed words firstWord to firstWord + words - 1
+static inline void modMapIncrMark(modMapIncr_t* inc, size_t firstWord,
+		size_t words)
+{
+	size_t b, last;
+	if (words == 0 || firstWord >= inc->inWords) {
+		return;
+	}
+	last = (firstWord + words - 1) / inc->blockWords;
+	if (last >= inc->numBlocks) {
+		last = inc->numBlocks - 1;
+	}
+	for (b = firstWord / inc->blockWords; b <= last; ++b) {
+		inc->dirty[b / 64] |= 1ULL << (b % 64);
+	}
+}
+
+// mark every block that differs from the input last mapped, returns the
+// number of blocks marked
+static inline size_t modMapIncrDiff(modMapIncr_t* inc, const uint32_t* in)
+{
+	size_t b, marked = 0;
+	for (b = 0; b < inc->numBlocks; ++b) {
+		size_t first = b * inc->blockWords;
+		size_t words = (first + inc->blockWords <= inc->inWords) ?
+				inc->blockWords : inc->inWords - first;
+		if (memcmp(&in[first], &inc->shadow[first],
+				words * sizeof(uint32_t)) != 0) {
+			inc->dirty[b / 64] |= 1ULL << (b % 64);
+			++marked;
+		}
+	}
+	return marked;
+}
+
+// map the dirty blocks of in into out, out keeps the words of the clean
+// blocks from earlier runs, the new output words also go to dev when it is
+// not NULL, up to devWords words, returns the number of blocks mapped
+static inline size_t modMapIncrRun(modMapIncr_t* inc, const uint32_t* in,
+		uint32_t* out, volatile uint32_t* dev, size_t devWords)
+{
+	// from the context as it is now, it may have been set up again since
+	// modMapIncrInit, out must be sized for the current configuration
+	uint32_t symsPerWord = 32 / inc->ctx->cfg.bitsPerSym;
+	size_t b, w, mapped = 0;
+
+	for (b = 0; b < inc->numBlocks; ++b) {
+		size_t first = b * inc->blockWords;
+		size_t words, outFirst, outWords;
+
+		if (inc->valid && (inc->dirty[b / 64] & (1ULL << (b % 64))) == 0) {
+			continue;
+		}
+		words = (first + inc->blockWords <= inc->inWords) ?
+				inc->blockWords : inc->inWords - first;
+		outFirst = first * symsPerWord;
+		outWords = words * symsPerWord;
+		modMapRunAt(inc->ctx, &in[first], &out[outFirst], words,
+				(uint32_t)outFirst);
+		memcpy(&inc->shadow[first], &in[first], words * sizeof(uint32_t));
+		if (dev != NULL && outFirst < devWords) {
+			if (outFirst + outWords > devWords) {
+				outWords = devWords - outFirst;
+			}
+			SOC_REG_BARRIER();
+			for (w = 0; w < outWords; ++w) {
+				dev[outFirst + w] = out[outFirst + w];
+			}
+			inc->devWordsWritten += outWords;
+		}
+		++mapped;
+	}
+	memset(inc->dirty, 0, (inc->numBlocks + 63) / 64 * sizeof(uint64_t));
+	inc->valid = 1;
+	inc->frames++;
+	inc->blocksMapped += mapped;
+	inc->blocksTotal += inc->numBlocks;
+	return mapped;
+}
+
+static inline void modMapIncrReport(const modMapIncr_t* inc, FILE* out)
+{
+	fprintf(out, "%llu frames, %llu of %llu blocks mapped (%.1f%%), %llu "
+			"device words written\n", (unsigned long long)inc->frames,
+			(unsigned long long)inc->blocksMapped,
+			(unsigned long long)inc->blocksTotal,
+			inc->blocksTotal ? 100.0 * inc->blocksMapped / inc->blocksTotal :
+					0.0, (unsigned long long)inc->devWordsWritten);
+}
+
+#endif // MOD_MAP_INCR_H
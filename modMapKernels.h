@@ -0,0 +1,128 @@
+/*****************************************************************************
+ *
+ * modMapKernels.h
+ *
+ * Frame kernels for modMap.h specialized at compile time for each
+ * modulation, frame size and phase ramp setting, chosen once at
+ * configuration time through a dispatch table.
+ *
+ * The generic modMapRun takes the bits per symbol, the frame size and the
+ * ramp from the context at run time, so its symbol loop has a variable
+ * shift, mask and trip count and always does the complex rotation.  Every
+ * kernel here is generated by MOD_MAP_KERNEL with those as constants, the
+ * symbol loop of a word is unrolled with constant shifts and masks, the
+ * word loop has a constant trip count and a kernel without ramp drops the
+ * rotation.  The output is identical to modMapRun.
+ *
+ * modMapSpecialize is called after modMapSetup with the frame size that
+ * will be mapped and sets the context's kernel and runWords, modMapFrames
+ * then maps through it and falls back to modMapRun for frames of another
+ * size.  Frame sizes without a kernel keep modMapRun.  A kernel called
+ * directly asserts its frame size.  Add a row to MOD_MAP_FRAME_SIZES for
+ * another frame size.
+ *
+ * 		modMapSetup(&ctx, &cfg);
+ * 		modMapSpecialize(&ctx, inWords);
+ * 		modMapFrames(&ctx, in, out, inWords, k);
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef MOD_MAP_KERNELS_H
+#define MOD_MAP_KERNELS_H
+
+#include <assert.h>
+#include "modMap.h"
+
+// frame sizes in input words with specialized kernels
+#define MOD_MAP_FRAME_SIZES(X, bits, ramp) \
+	X(bits, 16, ramp) \
+	X(bits, 64, ramp) \
+	X(bits, 256, ramp)
+
+#define MOD_MAP_KERNEL(bits, words, ramp) \
+static inline void modMapRun_##bits##_##words##_##ramp( \
+		const modMapCtx_t* ctx, const uint32_t* in, uint32_t* out, \
+		size_t inWords) \
+{ \
+	uint32_t n = 0; \
+	size_t w; \
+	int s; \
+	assert(inWords == (words)); \
+	(void)inWords; \
+	for (w = 0; w < (words); ++w) { \
+		uint32_t word = in[w]; \
+		_Pragma("GCC unroll 32") \
+		for (s = 0; s < 32 / (bits); ++s) { \
+			const double* p = \
+					ctx->point[(word >> (s * (bits))) & ((1u << (bits)) - 1)]; \
+			if (ramp) { \
+				const double* r = ctx->rot[(n + s) & ctx->rotMask]; \
+				*out++ = modMapPack(p[0] * r[0] - p[1] * r[1], \
+						p[0] * r[1] + p[1] * r[0]); \
+			} \
+			else { \
+				*out++ = modMapPack(p[0], p[1]); \
+			} \
+		} \
+		n += 32 / (bits); \
+	} \
+}
+
+#define MOD_MAP_KERNELS(bits) \
+	MOD_MAP_FRAME_SIZES(MOD_MAP_KERNEL, bits, 0) \
+	MOD_MAP_FRAME_SIZES(MOD_MAP_KERNEL, bits, 1)
+
+MOD_MAP_KERNELS(1)
+MOD_MAP_KERNELS(2)
+MOD_MAP_KERNELS(4)
+MOD_MAP_KERNELS(8)
+
+typedef struct {
+	uint32_t bitsPerSym;
+	uint32_t inWords;
+	int ramp;
+	modMapKernel_t run;
+} modMapKernelEntry_t;
+
+#define MOD_MAP_ENTRY(bits, words, ramp) \
+	{ bits, words, ramp, modMapRun_##bits##_##words##_##ramp },
+
+#define MOD_MAP_ENTRIES(bits) \
+	MOD_MAP_FRAME_SIZES(MOD_MAP_ENTRY, bits, 0) \
+	MOD_MAP_FRAME_SIZES(MOD_MAP_ENTRY, bits, 1)
+
+// kernel for a configuration and frame size, NULL when there is none
+static inline modMapKernel_t modMapLookup(const modMapCfg_t* cfg,
+		size_t inWords)
+{
+	static const modMapKernelEntry_t table[] = {
+		MOD_MAP_ENTRIES(1)
+		MOD_MAP_ENTRIES(2)
+		MOD_MAP_ENTRIES(4)
+		MOD_MAP_ENTRIES(8)
+	};
+	int ramp = cfg->rotPeriod > 1;
+	size_t i;
+
+	for (i = 0; i < sizeof(table) / sizeof(table[0]); ++i) {
+		if (table[i].bitsPerSym == cfg->bitsPerSym &&
+				table[i].inWords == inWords && table[i].ramp == ramp) {
+			return table[i].run;
+		}
+	}
+	return NULL;
+}
+
+// switch a set up context to the kernel for frames of inWords, returns 1
+// when a specialized kernel was found and 0 when modMapRun stays
+static inline int modMapSpecialize(modMapCtx_t* ctx, size_t inWords)
+{
+	modMapKernel_t run = modMapLookup(&ctx->cfg, inWords);
+	ctx->run = (run != NULL) ? run : modMapRun;
+	ctx->runWords = (run != NULL) ? inWords : 0;
+	return run != NULL;
+}
+
+#endif // MOD_MAP_KERNELS_H
@@ -0,0 +1,1029 @@
+/*****************************************************************************
+ *
+ * pthrdsThreeThrdsHWMapP10.c
+ *
+ * Modification to the example of creating three POSIX threads within a
+ * single process, the hardware mapping task now runs as its own RT process
+ * next to the LED and button threads.
+ *
+ * The program defined by this file encompasses step 10 of the progression
+ * defined below.
+ *
+ * 	1.	Two threads that each print a message.
+ * 	2.	Add turning an led on/off in each thread without interprocess
+ * 		communication (IPC).
+ * 	3.	Add mapping HPS and FPGA memory to virtual memory space, configure
+ * 		one thread for HPS LEDs, the other thread for FPGA LEDs.
+ * 	4.	Add either semaphore and mutex IPC.
+ * 	5.	Add mTenna hardware mapping to a third process that also sets global
+ * 		shared variables to indicate start and stop of the hardware mapping
+ * 		process.  Use the global shared variable state to control turning
+ * 		additional LEDs on/off.  Use standard linux timing functionality.
+ * 	6.	Optimize the mTenna hardware mapping by:
+ * 		a)	having other processes pend until execution is complete.
+ * 		b)	setting the RT priority to maximum and locking memory to prevent
+ * 			paging.
+ * 		c)	isolating the mTenna hardware mapping to cpu1 with all other
+ * 			processes running on cpu0.
+ * 		d)	compare RT performance to results from step 5.
+ * 	7.	Add higher resolution linux timer measurement, i.e. Posix clock,
+ * 		and possibly GPIO pin toggling to allow scope measurement.
+ * 	8.	Add reading GPIO and FPGA button states and starting hardware
+ * 		mapping on button push.
+ * 	9.	Add writing to and reading from FPGA on-chip Ram during mTenna
+ * 		hardware mapping.
+ * 	10.	Move the mTenna hardware mapping into a separate RT process that
+ * 		talks to the I/O process through shared memory, with an optional
+ * 		hot standby process that takes over when it stalls.
+ *
+ * Original code by Shawn Quinn
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "hardwareMapSoC.h"
+
+// register addresses, offsets and accessors for the HPS GPIO, FPGA PIO and
+// FPGA on-chip RAM are declared in the register map
+#include "socRegMap.h"
+
+// define USE_GPIO_CDEV to read the GPIO2 buttons through the GPIO character
+// device instead of the /dev/mem register mapping
+//#define USE_GPIO_CDEV
+#ifdef USE_GPIO_CDEV
+#include "gpioCdev.h"
+#define GPIO_CDEV_KEY_CHIP		"/dev/gpiochip2"	// chip for ff70a000.gpio
+#define GPIO_CDEV_KEY0_LINE		21					// line offset HPS button 0
+#define GPIO_CDEV_DEBOUNCE_US	5000				// button debounce period
+#endif
+
+// define USE_UIO_EVENTS to pace the mapping task on FPGA interrupts through
+// a UIO device instead of a fixed usleep period, UIO_FPGA_DEV may be set to
+// UIO_EVENT_SIM to run without the FPGA interrupt
+//#define USE_UIO_EVENTS
+#ifdef USE_UIO_EVENTS
+#include "uioEvent.h"
+#define UIO_FPGA_DEV			"/dev/uio0"	// FPGA buffer-empty interrupt
+#define UIO_FPGA_TIMEOUT_MS		100			// fall back to the old period
+#endif
+
+// define SCOPE_MARKERS to drive GPIO1 LED0 high while the mapping runs and
+// LED2 high while the measurement is written to FPGA RAM, for timing with a
+// scope, SCOPE_MARKER_LOG additionally logs every edge for correlation
+//#define SCOPE_MARKERS
+//#define SCOPE_MARKER_LOG
+#include "scopeMarker.h"
+#define SCOPE_MAP_CALC			0			// calcModAndMapBits region
+#define SCOPE_FPGA_WRITE		1			// FPGA RAM measurement write
+
+// with scope markers enabled the GPIO1 DR register is written through the
+// marker shadow, so the LED toggles must go through it as well
+#ifdef SCOPE_MARKERS
+#define GPIO1_LEDS_ON(mask)		scopeMarkerRegSet(&gpio1Markers, (mask))
+#define GPIO1_LEDS_OFF(mask)	scopeMarkerRegClear(&gpio1Markers, (mask))
+#else
+#define GPIO1_LEDS_ON(mask)		gpio1DrSetBits(gpio1Regs, (mask))
+#define GPIO1_LEDS_OFF(mask)	gpio1DrClearBits(gpio1Regs, (mask))
+#endif
+
+// phases of the mapping task cycle, each one is timed separately and
+// reported as a stacked cycle budget when the task exits
+#include "phaseBudget.h"
+#include "benchResults.h"
+
+// the last task cycles, button presses and FPGA RAM writes are kept in a
+// flight recorder ring in FPGA on-chip RAM, read it back after a crash or
+// reset with flightDecode -m
+#include "flightRecorder.h"
+#define FR_TASK_MAP				3			// taskThree in cycle events
+#define FR_SRC_GPIO2			0			// button event sources
+#define FR_SRC_FPGA				1
+
+// on a fatal signal the phase histograms, counters, marker shadow and the
+// FPGA RAM measurements are written to the crash dump file before exiting
+#include "crashDump.h"
+#define CRASH_DUMP_FILE			"p10Crash.txt"
+
+// taskThree is forked into its own RT process, so a fault in the LED and
+// button tasks cannot stop the mapping and only the engine's memory is
+// locked, loop counts go to the engine and completed cycles come back
+// through the mapEngine.h shared memory rings
+#include "mapEngine.h"
+#define MAP_MONITOR_POLL_MS		50			// engine liveness check period
+#define MAP_ENGINE_START_MS		3000		// allowed until the first beat
+
+// define MAP_ENGINE_STANDBY to fork a hot standby engine, it keeps
+// the mappings and locked memory of the active one, watches its heartbeat
+// and takes over the mapping within one cycle when it stalls or dies,
+// MAP_ENGINE_STALL_AT stops the active engine at that cycle to exercise it
+//#define MAP_ENGINE_STANDBY
+#ifndef MAP_ENGINE_STALL_AT
+#define MAP_ENGINE_STALL_AT		0			// zero never stalls
+#endif
+#define MY_STANDBY_PRIORITY		98			// below the active engine
+#define STANDBY_CPU				0			// off the engine's cpu1
+
+// define MAP_DEADLINE to move taskThree from SCHED_FIFO to SCHED_DEADLINE
+// after MAP_DL_CALIBRATE cycles, the runtime is the worst cpu time of a
+// cycle so far plus MAP_DL_MARGIN_PCT, so a runaway calcModAndMapBits is
+// throttled instead of starving cpu1, throttling is counted through
+// SIGXCPU and recorded in the flight recorder, the kernel only accepts it
+// when cpu1 is an exclusive cpuset, run under rtPartition setup 1, the
+// period is a whole cycle since the cpu time is measured per cycle
+//#define MAP_DEADLINE
+#ifdef MAP_DEADLINE
+#include "rtDeadline.h"
+#endif
+#define MAP_DL_CALIBRATE		5			// SCHED_FIFO cycles measured first
+#define MAP_DL_MARGIN_PCT		50			// runtime above the worst cycle
+#define MAP_DL_PERIOD_NS		200000000ULL	// one cycle, both 100 msec waits
+
+// MAP_CHANNELS independent mapping channels, taskThree is channel 0 and
+// starts the others as mapChannels.h threads with the period, cpu and
+// priority of mapChannelCfg, each maps its own buffer and writes its
+// execution times only into its own slice of the FPGA RAM array
+#include "mapChannels.h"
+#ifndef MAP_CHANNELS
+#define MAP_CHANNELS			1
+#endif
+#if MAP_CHANNELS < 1 || MAP_CHANNELS > MAP_MAX_CHANNELS
+#error MAP_CHANNELS out of range
+#endif
+
+enum {
+	PH_PRINT_ON, PH_LED_ON, PH_CLOCK_START, PH_MAP, PH_CLOCK_END,
+	PH_FPGA_WRITE, PH_WAIT_ON, PH_PRINT_OFF, PH_LED_OFF, PH_WAIT_OFF,
+	NUM_PHASES
+};
+const char* phaseNames[NUM_PHASES] = {
+	"printf led3 on", "GPIO1 led3 on", "clock_gettime start",
+	"calcModAndMapBits", "clock_gettime end", "FPGA RAM write",
+	"wait led3 on", "printf led3 off", "GPIO1 led3 off", "wait led3 off"
+};
+
+// other defined parameters...
+#define PAGE_SIZE				4096		// linux page size
+#define	MEAS_ARRAY_SIZE			50
+#define MY_RT_PRIORITY 			99 			// Highest possible priority
+
+// declare uninitialized task variables to pass to the tasks
+pthread_t taskOneVar;
+pthread_t taskTwoVar;
+pthread_t taskThreeVar;
+
+// initialize global shared variables to hold thread ids
+pthread_t gThd1IdHolder = 0;
+pthread_t gThd2IdHolder = 0;
+
+// declare variables to store time measurement parameters
+struct timespec tsStart;
+struct timespec tsEnd;
+uint32_t times[MEAS_ARRAY_SIZE];
+// interval timing uses the monotonic clock, CLOCK_REALTIME can be stepped by
+// NTP or settimeofday in the middle of a measurement, clockSourceBench shows
+// the cost and resolution of each clock on the running kernel
+clockid_t clkID = CLOCK_MONOTONIC;
+
+// initialize global shared variable to hold thread loop counter
+uint32_t gThdLoopCnt = 0;
+
+// initialize global shared variable to hold measurement count
+uint32_t measurementCnt = 0;
+
+// declare a shared variable mutex to be used to coordinate loop count access
+pthread_mutex_t sharedVariableMutex;
+
+// declare a semaphore to coordinate LED toggle between tasks
+sem_t semLED;
+
+// per-phase latency histograms for the mapping task cycle
+phaseBudget_t mapBudget;
+
+// black-box event ring, disabled until FPGA RAM is mapped
+flightRec_t flightRec;
+
+#ifdef MAP_DEADLINE
+// cpu time per mapping cycle and SCHED_DEADLINE throttling statistics
+rtDeadline_t mapDeadline;
+#endif
+
+mapEngineShm_t* mapShm;			// rings shared with the engine process
+pthread_t mapMonitorVar;		// I/O side consumer of engine messages
+int engineTakeover = 0;			// this engine took over from a stalled one
+int engineAttached = 0;			// I/O process joined a running engine
+
+// called with sharedVariableMutex held, which also serialises the two
+// producers of the ring towards the engine
+void mapEnginePostLoopCnt(void)
+{
+	mapMsg_t msg = { .type = MAP_MSG_LOOP_CNT, .value = gThdLoopCnt };
+	mapRingPush(&mapShm->toEngine, &msg);
+}
+
+// engine side, take the latest loop count without blocking
+void mapEngineSync(void)
+{
+	mapMsg_t msg;
+	while (mapRingPop(&mapShm->toEngine, &msg, 0)) {
+		if (msg.type == MAP_MSG_LOOP_CNT) {
+			gThdLoopCnt = msg.value;
+		}
+	}
+}
+
+// I/O side, the engine died or stopped without sending MAP_MSG_EXIT and no
+// standby took over, stop whatever is left of it so the waits in main end
+int mapEngineLost(uint64_t startNs)
+{
+	int64_t age = mapEngineBeatAgeMs(mapShm);
+	uint32_t active;
+
+	if (__atomic_load_n(&mapShm->state.done, __ATOMIC_ACQUIRE)) {
+		return 1;
+	}
+	if (age < 0 ? mapNowNs() - startNs <
+			(uint64_t)MAP_ENGINE_START_MS * 1000000ULL :
+			age < MAP_ENGINE_LOST_MS) {
+		return 0;
+	}
+	printf("\nmap engine lost, %s\n\n", (age < 0) ?
+			"it never started" : "heartbeat stopped");
+	active = __atomic_load_n(&mapShm->state.activePid, __ATOMIC_ACQUIRE);
+	__atomic_store_n(&mapShm->state.done, 1, __ATOMIC_RELEASE);
+	if (active != 0) {
+		kill((pid_t)active, SIGKILL);
+	}
+	if (mapShm->enginePid != 0 && mapShm->enginePid != active) {
+		kill((pid_t)mapShm->enginePid, SIGKILL);
+	}
+	return 1;
+}
+
+// I/O side, report each engine cycle and stop the LED tasks when the
+// engine exits or is lost, the printing is kept out of the RT process
+void mapMonitor(void)
+{
+	mapMsg_t msg;
+	uint64_t startNs = mapNowNs();
+	for (;;) {
+		if (!mapRingPop(&mapShm->fromEngine, &msg, MAP_MONITOR_POLL_MS)) {
+			if (!mapEngineLost(startNs)) {
+				continue;
+			}
+			// the engine is finished or gone, take what it sent before
+			// that, its EXIT can land between the timeout and the check
+			if (!mapRingPop(&mapShm->fromEngine, &msg, 0)) {
+				break;
+			}
+		}
+		if (msg.type == MAP_MSG_DONE) {
+			printf("map engine cycle %u: %llu nsec, delivered after %llu "
+					"nsec\n", msg.cycle, (unsigned long long)msg.auxNs,
+					(unsigned long long)(mapNowNs() - msg.sentNs));
+		}
+		else if (msg.type == MAP_MSG_EXIT) {
+			measurementCnt = msg.value;
+			break;
+		}
+	}
+	pthread_cancel(gThd1IdHolder);
+	pthread_cancel(gThd2IdHolder);
+}
+
+
+// statically allocate a buffer for the modulation data
+uint32_t modBuff[MAX_SIZE];
+
+// declare variables for use in mapping hardware registers into process space
+int fdGpio1;					// file descriptor place holder for HPS GPIO1
+int fdGpio2;					// file descriptor place holder for HPS GPIO2
+int fdFpgaPio;					// file descriptor place holder for FPGA slave
+int fdFpgaMem;					// file descriptor place holder for FPGA
+								// on-chip RAM
+#ifdef USE_GPIO_CDEV
+int fdGpioKeys;					// line request descriptor for GPIO2 buttons
+#endif
+#ifdef USE_UIO_EVENTS
+uioEvent_t fpgaEvent;			// FPGA interrupt wakeup source
+#endif
+scopeMarkerReg_t gpio1Markers;	// shadow of GPIO1 DR for scope markers
+volatile uint32_t*	gpio1BaseAddrPtr;	// holds return value from mmap call
+volatile uint32_t*	gpio2BaseAddrPtr;	// holds return value from mmap call
+volatile uint8_t*	fpgaPioBaseAddrPtr;	// holds return value from mmap call
+volatile uint8_t*	fpgaMemBaseAddrPtr;	// holds return value from mmap call
+gpio1Base_t gpio1Regs;			// typed register handles of the mappings,
+gpio2Base_t gpio2Regs;			// each region's accessors only take its own
+fpgaPioBase_t fpgaPioRegs;
+fpgaMemBase_t fpgaMemRegs;
+
+#if MAP_CHANNELS > 1
+// channels 1 and up, channel 0 is taskThree itself
+typedef struct {
+	uint32_t periodUs;
+	int cpu;
+	int priority;
+} mapChannelCfg_t;
+const mapChannelCfg_t mapChannelCfg[MAP_MAX_CHANNELS - 1] = {
+	{ 200000, 1, 97 },
+	{ 200000, 0, 96 },
+	{ 200000, 0, 95 },
+};
+mapChannel_t mapChan[MAP_CHANNELS - 1];
+volatile int mapChanStop = 0;
+
+void mapChanCalc(uint32_t* buf, size_t words)
+{
+	(void)words;
+	calcModAndMapBits(buf);
+}
+
+void mapChannelsStart(void)
+{
+	int c;
+	for (c = 0; c < MAP_CHANNELS - 1; ++c) {
+		if (mapChannelInit(&mapChan[c], c + 1, MAP_CHANNELS, MAX_SIZE,
+				mapChanCalc, fpgaMemRegs) != 0) {
+			continue;
+		}
+		mapChan[c].periodUs = mapChannelCfg[c].periodUs;
+		mapChan[c].cpu = mapChannelCfg[c].cpu;
+		mapChan[c].priority = mapChannelCfg[c].priority;
+		// a channel that failed to start is skipped by mapChannelsStop
+		if (mapChannelStart(&mapChan[c], &mapChanStop) != 0) {
+			mapChannelFree(&mapChan[c]);
+		}
+	}
+}
+
+void mapChannelsStop(void)
+{
+	int c;
+	mapChanStop = 1;
+	printf("\n");
+	for (c = 0; c < MAP_CHANNELS - 1; ++c) {
+		if (mapChan[c].buf == NULL) {
+			continue;
+		}
+		mapChannelJoin(&mapChan[c]);
+		mapChannelReport(&mapChan[c], stdout);
+		mapChannelFree(&mapChan[c]);
+	}
+}
+#endif
+
+// This is the master or producer task that signals the slave or consumer task
+// when it is allowed to execute
+void taskOne(void)
+{
+	crashDumpThreadInit();
+	printf("TaskOne process ID is %d\n", (int)getpid());
+	gThd1IdHolder = pthread_self();
+	printf("TaskOne thread ID is %d\n", (int)gThd1IdHolder);
+	while(1) {
+		if (gThdLoopCnt % 2) {
+			// set the correct bit to turn on GPIO1 led one
+			printf("turning GPIO1 led1 on...\n");
+			GPIO1_LEDS_ON(HPS_GPIO1_LED1);
+		}
+		else {
+			// turn off GPIO1 led one, read-modify-write
+			printf("turning GPIO1 led1 off...\n");
+			GPIO1_LEDS_OFF(HPS_GPIO1_LED1);
+		}
+		usleep(500000);
+
+
+		// read one of the four GPIO buttons, assign the key number to the
+		// buttonSelect variable to select the applicable MACRO definition
+		uint32_t gpioButton;
+		uint32_t gpioButtonSelect = 3;
+		switch(gpioButtonSelect) {
+		case 0:
+			gpioButton = HPS_GPIO2_KEY0;
+			break;
+		case 1:
+			gpioButton = HPS_GPIO2_KEY1;
+			break;
+		case 2:
+			gpioButton = HPS_GPIO2_KEY2;
+			break;
+		case 3:
+			gpioButton = HPS_GPIO2_KEY3;
+			break;
+		default:
+			break;
+		}
+#ifdef USE_GPIO_CDEV
+		// the key lines were requested in order, so the line index is the
+		// key number, keys are active low
+		uint64_t keyBits = ~0ULL;
+		gpioCdevGet(fdGpioKeys, 1ULL << gpioButtonSelect, &keyBits);
+		(void)gpioButton;
+		if ((keyBits & (1ULL << gpioButtonSelect)) == 0) {
+#else
+		if (gpio2KeyPressed(gpio2Regs, gpioButton)) {
+#endif
+			printf("\nGPIO2 button key%u pressed...\n\n", gpioButtonSelect);
+			flightRecord(&flightRec, FR_EV_BUTTON,
+					(FR_SRC_GPIO2 << 8) | gpioButtonSelect, 1);
+		}
+
+		// Wait for the mutex before accessing the count variable
+		pthread_mutex_lock(&sharedVariableMutex);
+		gThdLoopCnt++;
+		mapEnginePostLoopCnt();
+		fpgaRamWordWrite(fpgaMemRegs, 0xEEFF);
+		flightRecord(&flightRec, FR_EV_REG_WRITE, FPGA_PIO_RAM_OFFSET, 0xEEFF);
+		printf("task one count = %d\n", gThdLoopCnt);
+
+		// Release the mutex for the other task to use
+		pthread_mutex_unlock(&sharedVariableMutex);
+
+		if (!(gThdLoopCnt % 5)) {
+			// post semaphore to signal task two to execute
+			sem_post(&semLED);
+		}
+	}
+	printf("\nTaskOne exiting...\n\n");
+}
+
+// This is the slave or consumer task under control of the master or
+// producer task
+void taskTwo(void)
+{
+	crashDumpThreadInit();
+	printf("TaskTwo process ID is %d\n", (int)getpid());
+	gThd2IdHolder = pthread_self();
+	printf("TaskTwo thread ID is %d\n", (int)gThd2IdHolder);
+	while(1) {
+		// pend on the semaphore from task one...
+		sem_wait(&semLED);
+		// set the correct bit to turn on FPGA led two
+		printf("turning FPGA led2 on...\n");
+		fpgaPioLedSetBits(fpgaPioRegs, FPGA_PIO_LED2);
+		usleep(1000000);
+		// turn off FPGA led two, read-modify-write
+		printf("turning FPGA led2 off...\n");
+		fpgaPioLedClearBits(fpgaPioRegs, FPGA_PIO_LED2);
+
+		// Wait for the mutex before accessing the count variable
+		pthread_mutex_lock(&sharedVariableMutex);
+		// modify the global shared variable..
+		gThdLoopCnt++;
+		mapEnginePostLoopCnt();
+		printf("task two count = %d RAM value = %d\n", gThdLoopCnt,
+				fpgaRamWordRead(fpgaMemRegs));
+
+		// Release the mutex for other task to use
+		pthread_mutex_unlock(&sharedVariableMutex);
+
+		// read one of the four FPGA buttons, assign the key number to the
+		// buttonSelect variable to select the applicable MACRO definition
+		uint32_t fpgaButton;
+		uint32_t fpgaButtonSelect = 1;
+		switch(fpgaButtonSelect) {
+		case 0:
+			fpgaButton = FPGA_PIO_KEY0;
+			break;
+		case 1:
+			fpgaButton = FPGA_PIO_KEY1;
+			break;
+		case 2:
+			fpgaButton = FPGA_PIO_KEY2;
+			break;
+		case 3:
+			fpgaButton = FPGA_PIO_KEY3;
+			break;
+		default:
+			break;
+		}
+		if (fpgaPioKeyPressed(fpgaPioRegs, fpgaButton)) {
+			printf("\nFPGA button key%u pressed...\n\n", fpgaButtonSelect);
+			flightRecord(&flightRec, FR_EV_BUTTON,
+					(FR_SRC_FPGA << 8) | fpgaButtonSelect, 1);
+		}
+	}
+}
+
+// This is the master or producer task that executes the hardware mapping
+// function.
+void taskThree(void)
+{
+	int cpu;
+	int retVal;
+	pthread_t threadID;
+	cpu_set_t cpuSet;
+	crashDumpThreadInit();
+	printf("TaskThree process ID is %d\n", (int)getpid());
+	threadID = pthread_self();
+	printf("TaskThree thread ID is %d\n", (int)threadID);
+
+	printf("\nzeroing the CPU mask...\n\n");
+	CPU_ZERO(&cpuSet);		// zero out all bits in mask
+	printf("\nsetting processor 1 with CPU_SET...\n\n");
+	CPU_SET(1, &cpuSet);	// set bit for processor 1
+	printf("\ncalling pthread_setaffinity_np()...\n\n");
+	retVal = pthread_setaffinity_np(threadID, sizeof(cpu_set_t), &cpuSet);
+	if ( retVal != 0 ) {
+		printf("could not set processor affinity...\n");
+	}
+	CPU_ZERO(&cpuSet);		// zero all bits again
+	cpu = CPU_ISSET(0, &cpuSet);
+	char* setStr = cpu ? "set" : "not set";
+	printf("\nafter clearing:  CPU 0 is %s in the mask\n", setStr);
+	cpu = CPU_ISSET(1, &cpuSet);
+	setStr = cpu ? "set" : "not set";
+	printf("\nafter clearing:  CPU 1 is %s in the mask\n", setStr);
+	retVal = pthread_getaffinity_np(threadID, sizeof(cpu_set_t), &cpuSet);
+	if ( retVal != 0 ) {
+		printf("could not get processor affinity...\n");
+	}
+	printf("\nafter calling pthread_getaffinity_np...\n\n");
+	int i;
+	for(i = 0; i < 2; ++i) {
+		cpu = CPU_ISSET(i, &cpuSet);
+		setStr = cpu ? "set" : "not set";
+		printf("CPU %d is %s in hard affinity\n", i, setStr);
+	}
+
+	int rc;
+	struct sched_param my_params;
+	// Passing zero specifies caller’s (our) policy
+	printf("\ncalling sched_setscheduler()...\n\n");
+	my_params.sched_priority = MY_RT_PRIORITY;
+	// Passing zero specifies callers (our) pid
+	rc = sched_setscheduler(0, SCHED_FIFO, &my_params);
+	if ( rc == -1 )
+		printf("could not change scheduler policy\n");
+	printf("\nlocking memory...\n\n");
+	mlockall(MCL_CURRENT | MCL_FUTURE);
+
+	phaseBudgetInit(&mapBudget, phaseNames, NUM_PHASES);
+#ifdef MAP_DEADLINE
+	rtDeadlineInit(&mapDeadline, MAP_DL_PERIOD_NS);
+#endif
+#if MAP_CHANNELS > 1
+	mapChannelsStart();
+#endif
+	// a standby taking over continues at once, it has no start up to wait for
+	if (!engineTakeover) {
+		sleep(1);
+	}
+	__atomic_store_n(&mapShm->state.activePid, (uint32_t)getpid(),
+			__ATOMIC_RELEASE);
+	mapEngineBeat(mapShm);
+	while(gThdLoopCnt < 30) {
+		// a standby has fenced this engine off, leave the outputs to it
+		if (!mapEngineIsActive(mapShm)) {
+			break;
+		}
+#if MAP_ENGINE_STALL_AT != 0
+		if (!engineTakeover && gThdLoopCnt >= MAP_ENGINE_STALL_AT) {
+			raise(SIGSTOP);
+		}
+#endif
+		mapEngineBeat(mapShm);
+#ifdef MAP_DEADLINE
+		rtDeadlineCycleStart(&mapDeadline);
+#endif
+		phaseBudgetStart(&mapBudget);
+		flightRecord(&flightRec, FR_EV_CYCLE_START, FR_TASK_MAP, gThdLoopCnt);
+		// set the correct bit to turn on GPIO1 led one
+		printf("turning GPIO1 led3 on...\n");
+		phaseBudgetMark(&mapBudget, PH_PRINT_ON);
+		GPIO1_LEDS_ON(HPS_GPIO1_LED3);
+		phaseBudgetMark(&mapBudget, PH_LED_ON);
+
+		// get the time at the start of the calculation
+		retVal = clock_gettime (clkID, &tsStart);
+		if (retVal < 0) {
+			printf("\nerror reading clock\n\n");
+		}
+		phaseBudgetMark(&mapBudget, PH_CLOCK_START);
+
+		// map the data
+		SCOPE_ENTER(SCOPE_MAP_CALC);
+		calcModAndMapBits(modBuff);
+		SCOPE_EXIT(SCOPE_MAP_CALC);
+		//calcModAndMapBits(bufferPtr);
+		phaseBudgetMark(&mapBudget, PH_MAP);
+
+		// get the time at the end of the calculation
+		retVal = clock_gettime (clkID, &tsEnd);
+		if (retVal < 0) {
+			printf("\nerror reading clock\n\n");
+		}
+		phaseBudgetMark(&mapBudget, PH_CLOCK_END);
+
+		// write each time measurement value into FPGA memory, channel 0's
+		// slice is at the start of the array
+		if (tsEnd.tv_nsec > tsStart.tv_nsec &&
+				measurementCnt < fpgaRamArrCount / MAP_CHANNELS) {
+			SCOPE_ENTER(SCOPE_FPGA_WRITE);
+			fpgaRamArrWriteAt(fpgaMemRegs, measurementCnt,
+					(uint32_t)(tsEnd.tv_nsec - tsStart.tv_nsec));
+			SCOPE_EXIT(SCOPE_FPGA_WRITE);
+			flightRecord(&flightRec, FR_EV_REG_WRITE,
+					FPGA_PIO_ARR_OFFSET + measurementCnt * sizeof(uint32_t),
+					(uint32_t)(tsEnd.tv_nsec - tsStart.tv_nsec));
+			++measurementCnt;
+		}
+		phaseBudgetMark(&mapBudget, PH_FPGA_WRITE);
+
+#ifdef USE_UIO_EVENTS
+		// block until the FPGA signals that it has consumed the buffer, the
+		// timeout keeps the old pacing when no interrupt arrives
+		if (uioEventWait(&fpgaEvent, UIO_FPGA_TIMEOUT_MS) == -1) {
+			printf("\nerror waiting for FPGA event\n\n");
+		}
+#else
+		usleep(100000);
+#endif
+		phaseBudgetMark(&mapBudget, PH_WAIT_ON);
+		mapEngineBeat(mapShm);
+
+		// turn off GPIO1 led three, read-modify-write
+		printf("turning GPIO1 led3 off...\n");
+		phaseBudgetMark(&mapBudget, PH_PRINT_OFF);
+		GPIO1_LEDS_OFF(HPS_GPIO1_LED3);
+		phaseBudgetMark(&mapBudget, PH_LED_OFF);
+
+		usleep(100000);
+		phaseBudgetMark(&mapBudget, PH_WAIT_OFF);
+		phaseBudgetEnd(&mapBudget);
+		flightRecord(&flightRec, FR_EV_CYCLE_END, FR_TASK_MAP,
+				(uint32_t)(tsEnd.tv_nsec - tsStart.tv_nsec));
+#ifdef MAP_DEADLINE
+		if (rtDeadlineCycleEnd(&mapDeadline) != 0) {
+			flightRecord(&flightRec, FR_EV_THROTTLE, FR_TASK_MAP,
+					mapDeadline.overrunsSeen);
+		}
+		if (!mapDeadline.active && mapDeadline.cycles == MAP_DL_CALIBRATE &&
+				rtDeadlineEnter(&mapDeadline, MAP_DL_MARGIN_PCT) != 0) {
+			printf("mapping stays at SCHED_FIFO %d\n", MY_RT_PRIORITY);
+		}
+#endif
+		// hand the cycle to the I/O process and pick up its loop count
+		mapMsg_t msg = { .type = MAP_MSG_DONE, .cycle = gThdLoopCnt,
+				.auxNs = (uint64_t)(tsEnd.tv_nsec - tsStart.tv_nsec) };
+		mapRingPush(&mapShm->fromEngine, &msg);
+		mapEngineSync();
+		mapEngineMirror(mapShm, gThdLoopCnt, measurementCnt);
+
+	}
+#if MAP_CHANNELS > 1
+	mapChannelsStop();
+#endif
+	phaseBudgetReport(&mapBudget, stdout);
+#ifdef MAP_DEADLINE
+	rtDeadlineReport(&mapDeadline, stdout);
+#endif
+	printf("\nTaskThree exiting...\n\n");
+	// EXIT goes out before done is set, a monitor that sees done finds
+	// the message already in the ring
+	if (mapEngineIsActive(mapShm)) {
+		mapMsg_t exitMsg = { .type = MAP_MSG_EXIT, .value = measurementCnt };
+		mapRingPush(&mapShm->fromEngine, &exitMsg);
+		__atomic_store_n(&mapShm->state.done, 1, __ATOMIC_RELEASE);
+	}
+}
+
+#ifdef MAP_ENGINE_STANDBY
+// standby engine process, waits at RT priority on the other cpu with its
+// memory locked and the mappings inherited, then carries on the mapping
+// from the mirrored state if the active engine stalls
+void mapStandby(void)
+{
+	struct sched_param my_params;
+	cpu_set_t cpuSet;
+
+	CPU_ZERO(&cpuSet);
+	CPU_SET(STANDBY_CPU, &cpuSet);
+	if ( sched_setaffinity(0, sizeof(cpu_set_t), &cpuSet) != 0 ) {
+		printf("could not set standby processor affinity...\n");
+	}
+	my_params.sched_priority = MY_STANDBY_PRIORITY;
+	if ( sched_setscheduler(0, SCHED_FIFO, &my_params) == -1 ) {
+		printf("could not change standby scheduler policy\n");
+	}
+	mlockall(MCL_CURRENT | MCL_FUTURE);
+	printf("standby engine %d waiting...\n", (int)getpid());
+
+	if ( !mapStandbyWait(mapShm) ) {
+		return;
+	}
+	gThdLoopCnt = mapShm->state.loopCnt;
+	measurementCnt = mapShm->state.measurementCnt;
+	flightRecord(&flightRec, FR_EV_FAILOVER, (uint32_t)getpid(),
+			(uint32_t)(mapShm->state.failoverNs / 1000));
+	printf("\nstandby engine %d took over %llu usec after the last "
+			"heartbeat\n\n", (int)getpid(),
+			(unsigned long long)(mapShm->state.failoverNs / 1000));
+	engineTakeover = 1;
+	taskThree();
+}
+#endif
+
+int main(void)
+{
+	printf("The main process ID is %d\n", (int)getpid());
+
+	// install the crash dump handler before any thread starts, so every
+	// thread inherits it
+	if ( crashDumpInit(CRASH_DUMP_FILE) == 0 ) {
+		crashDumpAddBudget("mapBudget", &mapBudget);
+#ifdef MAP_DEADLINE
+		crashDumpAddHist("mapDeadline.cpu", &mapDeadline.cpu);
+#endif
+		crashDumpAddWords("gThdLoopCnt", &gThdLoopCnt, 1);
+		crashDumpAddWords("measurementCnt", &measurementCnt, 1);
+		crashDumpAddWords("gpio1Markers.shadow", &gpio1Markers.shadow, 1);
+#ifdef SCOPE_MARKER_LOG
+		crashDumpAddRaw("scopeLog", scopeLog, sizeof(scopeLog));
+#endif
+	}
+
+	// call open to obtain a file descriptor into virtual memory space
+	printf("Attempting to open device file HPS GPIO1...\n\n");
+	fdGpio1 = open( "/dev/mem", ( O_RDWR | O_SYNC ));
+	if ( fdGpio1 == -1 ) {
+		printf("Cannot open device file.\n");
+	}
+
+	// call open to obtain a file descriptor into virtual memory space
+	printf("Attempting to open device file FPGA PIO...\n\n");
+	fdFpgaPio = open( "/dev/mem", ( O_RDWR | O_SYNC ));
+	if ( fdFpgaPio == -1 ) {
+		printf("Cannot open device file.\n");
+	}
+
+	// call open to obtain a file descriptor into virtual memory space
+	printf("Attempting to open device file HPS GPIO2...\n\n");
+	fdGpio2 = open( "/dev/mem", ( O_RDWR | O_SYNC ));
+	if ( fdGpio2 == -1 ) {
+		printf("Cannot open device file.\n");
+	}
+
+	// call open to obtain a file descriptor into virtual memory space
+	printf("Attempting to open device file FPGA MEM...\n\n");
+	fdFpgaMem = open( "/dev/mem", ( O_RDWR | O_SYNC ));
+	if ( fdFpgaMem == -1 ) {
+		printf("Cannot open device file.\n");
+	}
+
+	// map one page of hardware addresses into virtual memory beginning at
+	// the GPIO1 base address
+	printf("Attempting to map GPIO1 Base Register address...\n\n");
+	gpio1BaseAddrPtr = (volatile uint32_t*)mmap(NULL, PAGE_SIZE,
+			PROT_READ | PROT_WRITE, MAP_SHARED, fdGpio1, HPS_GPIO1_BASE);
+
+	if( gpio1BaseAddrPtr == MAP_FAILED ) {
+		printf( "ERROR: mmap() GPIO1 failed...\n" );
+		close( fdGpio1 );
+	}
+
+	// map 20 pages of hardware addresses into virtual memory beginning at
+	// the FPGA slave base address, to allow accessing all FPGA peripherals
+	printf("Attempting to map FPGA Slave Base Register address...\n\n");
+	fpgaPioBaseAddrPtr = (volatile uint8_t*)mmap(NULL, 20 * PAGE_SIZE,
+		PROT_READ | PROT_WRITE, MAP_SHARED, fdFpgaPio, HPS_FPGA_SLAVE_BASE);
+
+	if( fpgaPioBaseAddrPtr == MAP_FAILED ) {
+		printf( "ERROR: mmap() FPGA failed...\n" );
+		close( fdFpgaPio );
+	}
+
+	// map one page of hardware addresses into virtual memory beginning at
+	// the GPIO2 base address
+	printf("Attempting to map GPIO2 Base Register address...\n\n");
+	gpio2BaseAddrPtr = (volatile uint32_t*)mmap(NULL, PAGE_SIZE,
+			PROT_READ | PROT_WRITE, MAP_SHARED, fdGpio2, HPS_GPIO2_BASE);
+
+	if( gpio2BaseAddrPtr == MAP_FAILED ) {
+		printf( "ERROR: mmap() GPIO2 failed...\n" );
+		close( fdGpio2 );
+	}
+
+	// map 16 pages of hardware addresses into virtual memory beginning at
+	// the FPGA memory base address, to allow accessing FPGA on-chip Ram
+	printf("Attempting to map FPGA memory Base Register address...\n\n");
+	fpgaMemBaseAddrPtr = (volatile uint8_t*)mmap(NULL, HPS_FPGA_MEM_SIZE,
+		PROT_READ | PROT_WRITE, MAP_SHARED, fdFpgaMem, HPS_FPGA_MEM_BASE);
+
+	if( fpgaMemBaseAddrPtr == MAP_FAILED ) {
+		printf( "ERROR: mmap() FPGA failed...\n" );
+		close( fdFpgaMem );
+	}
+	gpio1Regs = gpio1Base(gpio1BaseAddrPtr);
+	gpio2Regs = gpio2Base(gpio2BaseAddrPtr);
+	fpgaPioRegs = fpgaPioBase(fpgaPioBaseAddrPtr);
+	fpgaMemRegs = fpgaMemBase(fpgaMemBaseAddrPtr);
+	if( fpgaMemBaseAddrPtr != MAP_FAILED ) {
+		if ( flightRecAttach(&flightRec, SOC_REG_ADDR(fpgaMemBaseAddrPtr, 32,
+				FPGA_FLIGHT_OFFSET), FPGA_FLIGHT_BYTES, 0) != 0 ) {
+			printf("Cannot start the flight recorder.\n");
+		}
+		crashDumpAddWords("fpgaRamArr", fpgaRamArrPtr(fpgaMemRegs),
+				fpgaRamArrCount);
+	}
+
+
+	// set the direction bits for the GPIO1 LEDS by writing to the DDR reg
+	gpio1DdrWrite(gpio1Regs, HPS_GPIO1_ALL_ON);
+
+	// set the direction bits for the GPIO2 buttons by writing to the DDR reg
+	gpio2DdrWrite(gpio2Regs, HPS_GPIO2_ALL_OFF);
+
+	// write 0s to correct bits in the dr register to turn the leds off
+	gpio1DrClearBits(gpio1Regs, HPS_GPIO1_ALL_ON);
+
+#ifdef SCOPE_MARKERS
+	// hand the GPIO1 DR register to the scope markers
+	scopeMarkerRegInit(&gpio1Markers,
+			SOC_REG_ADDR(gpio1BaseAddrPtr, 32, HPS_GPIO1_DR_OFF_BYT), 32);
+	scopeMarkerBind(SCOPE_MAP_CALC, "calcModAndMapBits", &gpio1Markers,
+			HPS_GPIO1_LED0);
+	scopeMarkerBind(SCOPE_FPGA_WRITE, "fpgaRamArrWrite", &gpio1Markers,
+			HPS_GPIO1_LED2);
+#endif
+
+#ifdef USE_UIO_EVENTS
+	printf("Attempting to open FPGA event device...\n\n");
+	if ( uioEventOpen(&fpgaEvent, UIO_FPGA_DEV) == -1 ) {
+		printf("Cannot open FPGA event device.\n");
+	}
+#endif
+
+#ifdef USE_GPIO_CDEV
+	// request the four GPIO2 button lines as debounced inputs
+	printf("Attempting to request GPIO2 button lines...\n\n");
+	uint32_t keyLines[4] = { GPIO_CDEV_KEY0_LINE, GPIO_CDEV_KEY0_LINE + 1,
+			GPIO_CDEV_KEY0_LINE + 2, GPIO_CDEV_KEY0_LINE + 3 };
+	fdGpioKeys = gpioCdevRequestInputs(GPIO_CDEV_KEY_CHIP, keyLines, 4,
+			GPIO_CDEV_EDGE_NONE, GPIO_CDEV_DEBOUNCE_US);
+	if ( fdGpioKeys == -1 ) {
+		printf("Cannot request GPIO2 button lines.\n");
+	}
+#endif
+
+	// Create the mutex for coordinating loop count shared variable access
+	// by LED tasks
+	pthread_mutex_init(&sharedVariableMutex, NULL);
+
+	// Create the semaphore for LED tasks with an initial value of zero
+	sem_init(&semLED, 0, 0);
+
+	// a restarted I/O process joins an engine that is still running,
+	// otherwise a fresh segment is created and the engine forked before any
+	// thread exists, so it inherits the mappings
+	pid_t enginePid = 0;
+#ifdef MAP_ENGINE_STANDBY
+	pid_t standbyPid = 0;
+#endif
+	mapShm = mapEngineShmMap(0);
+	if ( mapShm != NULL && mapEngineRunning(mapShm) ) {
+		printf("Attaching to the running map engine process %u...\n\n",
+				mapShm->state.activePid);
+		engineAttached = 1;
+	}
+	else {
+		if ( mapShm != NULL ) {
+			mapEngineShmUnmap(mapShm, 0);
+		}
+		printf("Attempting to start the map engine process...\n\n");
+		mapShm = mapEngineShmMap(1);
+		if ( mapShm == NULL ) {
+			printf("Cannot create map engine shared memory.\n");
+			return( 1 );
+		}
+	}
+	flightRecShareCounter(&flightRec, &mapShm->flightSeq);
+	if ( !engineAttached ) {
+		fflush(stdout);
+		enginePid = fork();
+		if ( enginePid == 0 ) {
+			taskThree();
+			fflush(stdout);
+			_exit(0);
+		}
+		if ( enginePid == -1 ) {
+			printf("Cannot fork the map engine process.\n");
+			return( 1 );
+		}
+		mapShm->enginePid = (uint32_t)enginePid;
+#ifdef MAP_ENGINE_STANDBY
+		standbyPid = fork();
+		if ( standbyPid == 0 ) {
+			mapStandby();
+			fflush(stdout);
+			_exit(0);
+		}
+		if ( standbyPid == -1 ) {
+			printf("Cannot fork the standby engine process.\n");
+		}
+#endif
+	}
+
+	// create the LED threads and the engine monitor
+	pthread_create(&taskOneVar, NULL, (void*)taskOne, NULL);
+	pthread_create(&taskTwoVar, NULL, (void*)taskTwo, NULL);
+	pthread_create(&mapMonitorVar, NULL, (void*)mapMonitor, NULL);
+
+	pthread_join(taskOneVar, NULL);
+	pthread_join(taskTwoVar, NULL);
+	pthread_join(mapMonitorVar, NULL);
+	if ( enginePid > 0 ) {
+		waitpid(enginePid, NULL, 0);
+	}
+#ifdef MAP_ENGINE_STANDBY
+	if ( standbyPid > 0 ) {
+		waitpid(standbyPid, NULL, 0);
+	}
+	printf("\nmap engine failovers: %u, last took %llu usec\n",
+			mapShm->state.failovers,
+			(unsigned long long)(mapShm->state.failoverNs / 1000));
+#endif
+	mapEngineShmUnmap(mapShm, 1);
+
+	// write 0s to correct bits in the dr register to turn the leds off
+	printf("\nturning all GPIO1 leds off...\n\n");
+	gpio1DrClearBits(gpio1Regs, HPS_GPIO1_ALL_ON);
+
+	// write 0s to the fpga pio register to turn the leds off
+	printf("turning all FPGA leds off...\n\n");
+	fpgaPioLedClearBits(fpgaPioRegs, FPGA_PIO_LED_ALL_ON);
+
+	// read out the time measurement values written to FPGA memory
+	printf("\ntimer measurements (nsec):\n\n");
+	uint64_t mapTimes[FPGA_PIO_ARR_WORDS];
+	int i;
+	for (i = 0; i < measurementCnt; ++i) {
+		mapTimes[i] = fpgaRamArrReadAt(fpgaMemRegs, i);
+		printf("interval %d:  %u\n", i, (uint32_t)mapTimes[i]);
+	}
+
+	// keep the run in the results store for comparison against a baseline
+	char config[64];
+	snprintf(config, sizeof(config), "MAX_SIZE=%d engine=process",
+			MAX_SIZE);
+	benchResultWrite("hwMapCalc", config, mapTimes, measurementCnt);
+
+	flightRecClose(&flightRec);
+
+	printf("\nAttempting to unmap GPIO1 Base Register address...\n\n");
+	if( munmap( (void*)gpio1BaseAddrPtr, PAGE_SIZE ) != 0 ) {
+		printf( "ERROR: munmap() failed...\n" );
+		close( fdGpio1 );
+		return( 1 );
+	}
+
+	printf("Attempting to unmap FPGA Slave Base Register address...\n\n");
+	if( munmap( (void*)fpgaPioBaseAddrPtr, 20 * PAGE_SIZE ) != 0 ) {
+		printf( "ERROR: munmap() failed...\n" );
+		close( fdFpgaPio );
+		return( 1 );
+	}
+
+	printf("Attempting to unmap GPIO2 Base Register address...\n\n");
+	if( munmap( (void*)gpio2BaseAddrPtr, PAGE_SIZE ) != 0 ) {
+		printf( "ERROR: munmap() failed...\n" );
+		close( fdGpio2 );
+		return( 1 );
+	}
+
+	printf("Attempting to unmap FPGA Memory Base Register address...\n\n");
+	if( munmap( (void*)fpgaMemBaseAddrPtr, 16 * PAGE_SIZE ) != 0 ) {
+		printf( "ERROR: munmap() failed...\n" );
+		close( fdFpgaMem );
+		return( 1 );
+	}
+
+#ifdef SCOPE_MARKER_LOG
+	scopeMarkerDump(stdout);
+#endif
+
+#ifdef USE_GPIO_CDEV
+	if ( fdGpioKeys != -1 ) {
+		close(fdGpioKeys);
+	}
+#endif
+#ifdef USE_UIO_EVENTS
+	uioEventClose(&fpgaEvent);
+#endif
+
+	printf("main exiting...\n\n");
+
+	return 0;
+}
@@ -51,46 +51,107 @@
 #include <sys/types.h>
 #include "hardwareMapSoC.h"
 
-// the following define the memory mapping for register access from the HPS
-// GPIO1 addresses and bit settings
-#define HPS_GPIO1_BASE 			0xFF709000	// base register address HPS GPIO1
-#define	HPS_GPIO1_DDR_OFF_BYT	0x04		// byte offset to DDR reg address
-#define HPS_GPIO1_LED0 			0x01000000	// word write value HPS LED0
-#define HPS_GPIO1_LED1 			0x02000000	// word write value HPS LED1
-#define HPS_GPIO1_LED2 			0x04000000	// word write value HPS LED2
-#define HPS_GPIO1_LED3 			0x08000000	// word write value HPS LED3
-#define HPS_GPIO1_ALL_ON		0x0F000000
-#define	HPS_GPIO1_ALL_OFF		0x00000000
-
-// GPIO2 addresses and bit settings
-#define HPS_GPIO2_BASE 			0xFF70A000	// base register address HPS GPIO2
-#define HPS_GPIO2_EXT_OFFSET	0x50
-#define	HPS_GPIO2_DDR_OFF_BYT	0x04		// byte offset to DDR reg address
-#define HPS_GPIO2_KEY0 			0x00200000	// word write value HPS button 0
-#define HPS_GPIO2_KEY1 			0x00400000	// word write value HPS button 1
-#define HPS_GPIO2_KEY2 			0x00800000	// word write value HPS button 2
-#define HPS_GPIO2_KEY3 			0x01000000	// word write value HPS button 3
-#define	HPS_GPIO2_ALL_OFF		0x00000000
-
-// FPGA PIO addresses and bit settings
-#define HPS_FPGA_SLAVE_BASE		0xFF200000	// base register address LW bridge
-#define FPGA_PIO_LED_OFFSET		0x00010040	// byte offset to LED reg address
-#define FPGA_PIO_LED0 			0x01		// byte write value to FPGA LED0
-#define FPGA_PIO_LED1 			0x02		// byte write value to FPGA LED1
-#define FPGA_PIO_LED2 			0x04		// byte write value to FPGA LED2
-#define FPGA_PIO_LED3 			0x08		// byte write value to FPGA LED3
-#define FPGA_PIO_LED_ALL_ON		0x0F
-#define FPGA_PIO_LED_ALL_OFF	0x00
-#define FPGA_PIO_KEY_OFFSET		0x000100C0	// byte offset to button reg addr
-#define FPGA_PIO_KEY0 			0x01		// byte write value to FPGA button 0
-#define FPGA_PIO_KEY1 			0x02		// byte write value to FPGA button 1
-#define FPGA_PIO_KEY2 			0x04		// byte write value to FPGA button 2
-#define FPGA_PIO_KEY3 			0x08		// byte write value to FPGA button 3
-#define HPS_FPGA_MEM_BASE		0xC0000000	// base register address FPGA RAM
-#define HPS_FPGA_MEM_SIZE		0x40000000	// FPGA RAM size in bytes
-#define FPGA_PIO_RAM_OFFSET		0x00		// byte offset to on-chip memory
-#define FPGA_PIO_ARR_OFFSET		0x00F		// byte offset to storage array
-#define FPGA_PIO_BUF_OFFSET		0x80F		// byte offset to storage buffer
+// register addresses, offsets and accessors for the HPS GPIO, FPGA PIO and
+// FPGA on-chip RAM are declared in the register map
+#include "socRegMap.h"
+
+// define USE_GPIO_CDEV to read the GPIO2 buttons through the GPIO character
+// device instead of the /dev/mem register mapping
+//#define USE_GPIO_CDEV
+#ifdef USE_GPIO_CDEV
+#include "gpioCdev.h"
+#define GPIO_CDEV_KEY_CHIP		"/dev/gpiochip2"	// chip for ff70a000.gpio
+#define GPIO_CDEV_KEY0_LINE		21					// line offset HPS button 0
+#define GPIO_CDEV_DEBOUNCE_US	5000				// button debounce period
+#endif
+
+// define USE_UIO_EVENTS to pace the mapping task on FPGA interrupts through
+// a UIO device instead of a fixed usleep period, UIO_FPGA_DEV may be set to
+// UIO_EVENT_SIM to run without the FPGA interrupt
+//#define USE_UIO_EVENTS
+#ifdef USE_UIO_EVENTS
+#include "uioEvent.h"
+#define UIO_FPGA_DEV			"/dev/uio0"	// FPGA buffer-empty interrupt
+#define UIO_FPGA_TIMEOUT_MS		100			// fall back to the old period
+#endif
+
+// define SCOPE_MARKERS to drive GPIO1 LED0 high while the mapping runs and
+// LED2 high while the measurement is written to FPGA RAM, for timing with a
+// scope, SCOPE_MARKER_LOG additionally logs every edge for correlation
+//#define SCOPE_MARKERS
+//#define SCOPE_MARKER_LOG
+#include "scopeMarker.h"
+#define SCOPE_MAP_CALC			0			// calcModAndMapBits region
+#define SCOPE_FPGA_WRITE		1			// FPGA RAM measurement write
+
+// with scope markers enabled the GPIO1 DR register is written through the
+// marker shadow, so the LED toggles must go through it as well
+#ifdef SCOPE_MARKERS
+#define GPIO1_LEDS_ON(mask)		scopeMarkerRegSet(&gpio1Markers, (mask))
+#define GPIO1_LEDS_OFF(mask)	scopeMarkerRegClear(&gpio1Markers, (mask))
+#else
+#define GPIO1_LEDS_ON(mask)		gpio1DrSetBits(gpio1Regs, (mask))
+#define GPIO1_LEDS_OFF(mask)	gpio1DrClearBits(gpio1Regs, (mask))
+#endif
+
+// phases of the mapping task cycle, each one is timed separately and
+// reported as a stacked cycle budget when the task exits
+#include "phaseBudget.h"
+#include "benchResults.h"
+
+// the last task cycles, button presses and FPGA RAM writes are kept in a
+// flight recorder ring in FPGA on-chip RAM, read it back after a crash or
+// reset with flightDecode -m
+#include "flightRecorder.h"
+#define FR_TASK_MAP				3			// taskThree in cycle events
+#define FR_SRC_GPIO2			0			// button event sources
+#define FR_SRC_FPGA				1
+
+// on a fatal signal the phase histograms, counters, marker shadow and the
+// FPGA RAM measurements are written to the crash dump file before exiting
+#include "crashDump.h"
+#define CRASH_DUMP_FILE			"p9Crash.txt"
+
+// the mapping engine as its own RT process, with an optional hot standby,
+// is pthrdsThreeThrdsHWMapP10.c
+
+// define MAP_DEADLINE to move taskThree from SCHED_FIFO to SCHED_DEADLINE
+// after MAP_DL_CALIBRATE cycles, the runtime is the worst cpu time of a
+// cycle so far plus MAP_DL_MARGIN_PCT, so a runaway calcModAndMapBits is
+// throttled instead of starving cpu1, throttling is counted through
+// SIGXCPU and recorded in the flight recorder, the kernel only accepts it
+// when cpu1 is an exclusive cpuset, run under rtPartition setup 1, the
+// period is a whole cycle since the cpu time is measured per cycle
+//#define MAP_DEADLINE
+#ifdef MAP_DEADLINE
+#include "rtDeadline.h"
+#endif
+#define MAP_DL_CALIBRATE		5			// SCHED_FIFO cycles measured first
+#define MAP_DL_MARGIN_PCT		50			// runtime above the worst cycle
+#define MAP_DL_PERIOD_NS		200000000ULL	// one cycle, both 100 msec waits
+
+// MAP_CHANNELS independent mapping channels, taskThree is channel 0 and
+// starts the others as mapChannels.h threads with the period, cpu and
+// priority of mapChannelCfg, each maps its own buffer and writes its
+// execution times only into its own slice of the FPGA RAM array
+#include "mapChannels.h"
+#ifndef MAP_CHANNELS
+#define MAP_CHANNELS			1
+#endif
+#if MAP_CHANNELS < 1 || MAP_CHANNELS > MAP_MAX_CHANNELS
+#error MAP_CHANNELS out of range
+#endif
+
+enum {
+	PH_PRINT_ON, PH_LED_ON, PH_CLOCK_START, PH_MAP, PH_CLOCK_END,
+	PH_FPGA_WRITE, PH_WAIT_ON, PH_PRINT_OFF, PH_LED_OFF, PH_WAIT_OFF,
+	NUM_PHASES
+};
+const char* phaseNames[NUM_PHASES] = {
+	"printf led3 on", "GPIO1 led3 on", "clock_gettime start",
+	"calcModAndMapBits", "clock_gettime end", "FPGA RAM write",
+	"wait led3 on", "printf led3 off", "GPIO1 led3 off", "wait led3 off"
+};
 
 // other defined parameters...
 #define PAGE_SIZE				4096		// linux page size
@@ -110,7 +171,10 @@ pthread_t gThd2IdHolder = 0;
 struct timespec tsStart;
 struct timespec tsEnd;
 uint32_t times[MEAS_ARRAY_SIZE];
-clockid_t clkID = CLOCK_REALTIME;
+// interval timing uses the monotonic clock, CLOCK_REALTIME can be stepped by
+// NTP or settimeofday in the middle of a measurement, clockSourceBench shows
+// the cost and resolution of each clock on the running kernel
+clockid_t clkID = CLOCK_MONOTONIC;
 
 // initialize global shared variable to hold thread loop counter
 uint32_t gThdLoopCnt = 0;
@@ -124,6 +188,19 @@ pthread_mutex_t sharedVariableMutex;
 // declare a semaphore to coordinate LED toggle between tasks
 sem_t semLED;
 
+// per-phase latency histograms for the mapping task cycle
+phaseBudget_t mapBudget;
+
+// black-box event ring, disabled until FPGA RAM is mapped
+flightRec_t flightRec;
+
+#ifdef MAP_DEADLINE
+// cpu time per mapping cycle and SCHED_DEADLINE throttling statistics
+rtDeadline_t mapDeadline;
+#endif
+
+
+
 // statically allocate a buffer for the modulation data
 uint32_t modBuff[MAX_SIZE];
 
@@ -133,16 +210,82 @@ int fdGpio2;					// file descriptor place holder for HPS GPIO2
 int fdFpgaPio;					// file descriptor place holder for FPGA slave
 int fdFpgaMem;					// file descriptor place holder for FPGA
 								// on-chip RAM
+#ifdef USE_GPIO_CDEV
+int fdGpioKeys;					// line request descriptor for GPIO2 buttons
+#endif
+#ifdef USE_UIO_EVENTS
+uioEvent_t fpgaEvent;			// FPGA interrupt wakeup source
+#endif
+scopeMarkerReg_t gpio1Markers;	// shadow of GPIO1 DR for scope markers
 volatile uint32_t*	gpio1BaseAddrPtr;	// holds return value from mmap call
 volatile uint32_t*	gpio2BaseAddrPtr;	// holds return value from mmap call
 volatile uint8_t*	fpgaPioBaseAddrPtr;	// holds return value from mmap call
 volatile uint8_t*	fpgaMemBaseAddrPtr;	// holds return value from mmap call
-uint32_t* timesPtr;				// pointer to hold start of array in FPGA RAM
+gpio1Base_t gpio1Regs;			// typed register handles of the mappings,
+gpio2Base_t gpio2Regs;			// each region's accessors only take its own
+fpgaPioBase_t fpgaPioRegs;
+fpgaMemBase_t fpgaMemRegs;
+
+#if MAP_CHANNELS > 1
+// channels 1 and up, channel 0 is taskThree itself
+typedef struct {
+	uint32_t periodUs;
+	int cpu;
+	int priority;
+} mapChannelCfg_t;
+const mapChannelCfg_t mapChannelCfg[MAP_MAX_CHANNELS - 1] = {
+	{ 200000, 1, 97 },
+	{ 200000, 0, 96 },
+	{ 200000, 0, 95 },
+};
+mapChannel_t mapChan[MAP_CHANNELS - 1];
+volatile int mapChanStop = 0;
+
+void mapChanCalc(uint32_t* buf, size_t words)
+{
+	(void)words;
+	calcModAndMapBits(buf);
+}
+
+void mapChannelsStart(void)
+{
+	int c;
+	for (c = 0; c < MAP_CHANNELS - 1; ++c) {
+		if (mapChannelInit(&mapChan[c], c + 1, MAP_CHANNELS, MAX_SIZE,
+				mapChanCalc, fpgaMemRegs) != 0) {
+			continue;
+		}
+		mapChan[c].periodUs = mapChannelCfg[c].periodUs;
+		mapChan[c].cpu = mapChannelCfg[c].cpu;
+		mapChan[c].priority = mapChannelCfg[c].priority;
+		// a channel that failed to start is skipped by mapChannelsStop
+		if (mapChannelStart(&mapChan[c], &mapChanStop) != 0) {
+			mapChannelFree(&mapChan[c]);
+		}
+	}
+}
+
+void mapChannelsStop(void)
+{
+	int c;
+	mapChanStop = 1;
+	printf("\n");
+	for (c = 0; c < MAP_CHANNELS - 1; ++c) {
+		if (mapChan[c].buf == NULL) {
+			continue;
+		}
+		mapChannelJoin(&mapChan[c]);
+		mapChannelReport(&mapChan[c], stdout);
+		mapChannelFree(&mapChan[c]);
+	}
+}
+#endif
 
 // This is the master or producer task that signals the slave or consumer task
 // when it is allowed to execute
 void taskOne(void)
 {
+	crashDumpThreadInit();
 	printf("TaskOne process ID is %d\n", (int)getpid());
 	gThd1IdHolder = pthread_self();
 	printf("TaskOne thread ID is %d\n", (int)gThd1IdHolder);
@@ -150,12 +293,12 @@ void taskOne(void)
 		if (gThdLoopCnt % 2) {
 			// set the correct bit to turn on GPIO1 led one
 			printf("turning GPIO1 led1 on...\n");
-			*(gpio1BaseAddrPtr) = *(gpio1BaseAddrPtr) | HPS_GPIO1_LED1;
+			GPIO1_LEDS_ON(HPS_GPIO1_LED1);
 		}
 		else {
 			// turn off GPIO1 led one, read-modify-write
 			printf("turning GPIO1 led1 off...\n");
-			*(gpio1BaseAddrPtr) = *(gpio1BaseAddrPtr) & (~(HPS_GPIO1_LED1));
+			GPIO1_LEDS_OFF(HPS_GPIO1_LED1);
 		}
 		usleep(500000);
 
@@ -180,16 +323,26 @@ void taskOne(void)
 		default:
 			break;
 		}
-		if ( (( * ( (uint32_t*) ((uint8_t*)gpio2BaseAddrPtr + HPS_GPIO2_EXT_OFFSET) ) )
-				&  gpioButton )  == 0) {
+#ifdef USE_GPIO_CDEV
+		// the key lines were requested in order, so the line index is the
+		// key number, keys are active low
+		uint64_t keyBits = ~0ULL;
+		gpioCdevGet(fdGpioKeys, 1ULL << gpioButtonSelect, &keyBits);
+		(void)gpioButton;
+		if ((keyBits & (1ULL << gpioButtonSelect)) == 0) {
+#else
+		if (gpio2KeyPressed(gpio2Regs, gpioButton)) {
+#endif
 			printf("\nGPIO2 button key%u pressed...\n\n", gpioButtonSelect);
+			flightRecord(&flightRec, FR_EV_BUTTON,
+					(FR_SRC_GPIO2 << 8) | gpioButtonSelect, 1);
 		}
 
 		// Wait for the mutex before accessing the count variable
 		pthread_mutex_lock(&sharedVariableMutex);
 		gThdLoopCnt++;
-		// cast the byte pointer to a word pointer...
-		*((uint32_t*)(fpgaMemBaseAddrPtr + FPGA_PIO_RAM_OFFSET)) = 0xEEFF;
+		fpgaRamWordWrite(fpgaMemRegs, 0xEEFF);
+		flightRecord(&flightRec, FR_EV_REG_WRITE, FPGA_PIO_RAM_OFFSET, 0xEEFF);
 		printf("task one count = %d\n", gThdLoopCnt);
 
 		// Release the mutex for the other task to use
@@ -207,6 +360,7 @@ void taskOne(void)
 // producer task
 void taskTwo(void)
 {
+	crashDumpThreadInit();
 	printf("TaskTwo process ID is %d\n", (int)getpid());
 	gThd2IdHolder = pthread_self();
 	printf("TaskTwo thread ID is %d\n", (int)gThd2IdHolder);
@@ -215,21 +369,18 @@ void taskTwo(void)
 		sem_wait(&semLED);
 		// set the correct bit to turn on FPGA led two
 		printf("turning FPGA led2 on...\n");
-		*(fpgaPioBaseAddrPtr + FPGA_PIO_LED_OFFSET) =
-				*(fpgaPioBaseAddrPtr + FPGA_PIO_LED_OFFSET) | FPGA_PIO_LED2;
+		fpgaPioLedSetBits(fpgaPioRegs, FPGA_PIO_LED2);
 		usleep(1000000);
 		// turn off FPGA led two, read-modify-write
 		printf("turning FPGA led2 off...\n");
-		*(fpgaPioBaseAddrPtr + FPGA_PIO_LED_OFFSET) =
-			*(fpgaPioBaseAddrPtr + FPGA_PIO_LED_OFFSET) & (~(FPGA_PIO_LED2));
+		fpgaPioLedClearBits(fpgaPioRegs, FPGA_PIO_LED2);
 
 		// Wait for the mutex before accessing the count variable
 		pthread_mutex_lock(&sharedVariableMutex);
 		// modify the global shared variable..
 		gThdLoopCnt++;
-		// cast the byte pointer to a word pointer...
 		printf("task two count = %d RAM value = %d\n", gThdLoopCnt,
-				*((uint32_t*)(fpgaMemBaseAddrPtr + FPGA_PIO_RAM_OFFSET)));
+				fpgaRamWordRead(fpgaMemRegs));
 
 		// Release the mutex for other task to use
 		pthread_mutex_unlock(&sharedVariableMutex);
@@ -254,8 +405,10 @@ void taskTwo(void)
 		default:
 			break;
 		}
-		if ( (*(fpgaPioBaseAddrPtr + FPGA_PIO_KEY_OFFSET)  &  fpgaButton)   == 0) {
+		if (fpgaPioKeyPressed(fpgaPioRegs, fpgaButton)) {
 			printf("\nFPGA button key%u pressed...\n\n", fpgaButtonSelect);
+			flightRecord(&flightRec, FR_EV_BUTTON,
+					(FR_SRC_FPGA << 8) | fpgaButtonSelect, 1);
 		}
 	}
 }
@@ -266,10 +419,9 @@ void taskThree(void)
 {
 	int cpu;
 	int retVal;
-	uint32_t* timesPtr = (uint32_t*)(fpgaMemBaseAddrPtr + FPGA_PIO_ARR_OFFSET);
-	//uint32_t* bufferPtr = (uint32_t*)(fpgaMemBaseAddrPtr + FPGA_PIO_BUF_OFFSET);
 	pthread_t threadID;
 	cpu_set_t cpuSet;
+	crashDumpThreadInit();
 	printf("TaskThree process ID is %d\n", (int)getpid());
 	threadID = pthread_self();
 	printf("TaskThree thread ID is %d\n", (int)threadID);
@@ -314,51 +466,128 @@ void taskThree(void)
 	printf("\nlocking memory...\n\n");
 	mlockall(MCL_CURRENT | MCL_FUTURE);
 
+	phaseBudgetInit(&mapBudget, phaseNames, NUM_PHASES);
+#ifdef MAP_DEADLINE
+	rtDeadlineInit(&mapDeadline, MAP_DL_PERIOD_NS);
+#endif
+#if MAP_CHANNELS > 1
+	mapChannelsStart();
+#endif
 	sleep(1);
 	while(gThdLoopCnt < 30) {
+#ifdef MAP_DEADLINE
+		rtDeadlineCycleStart(&mapDeadline);
+#endif
+		phaseBudgetStart(&mapBudget);
+		flightRecord(&flightRec, FR_EV_CYCLE_START, FR_TASK_MAP, gThdLoopCnt);
 		// set the correct bit to turn on GPIO1 led one
 		printf("turning GPIO1 led3 on...\n");
-		*(gpio1BaseAddrPtr) = *(gpio1BaseAddrPtr) | HPS_GPIO1_LED3;
+		phaseBudgetMark(&mapBudget, PH_PRINT_ON);
+		GPIO1_LEDS_ON(HPS_GPIO1_LED3);
+		phaseBudgetMark(&mapBudget, PH_LED_ON);
 
 		// get the time at the start of the calculation
 		retVal = clock_gettime (clkID, &tsStart);
 		if (retVal < 0) {
 			printf("\nerror reading clock\n\n");
 		}
+		phaseBudgetMark(&mapBudget, PH_CLOCK_START);
 
 		// map the data
+		SCOPE_ENTER(SCOPE_MAP_CALC);
 		calcModAndMapBits(modBuff);
+		SCOPE_EXIT(SCOPE_MAP_CALC);
 		//calcModAndMapBits(bufferPtr);
+		phaseBudgetMark(&mapBudget, PH_MAP);
 
 		// get the time at the end of the calculation
 		retVal = clock_gettime (clkID, &tsEnd);
 		if (retVal < 0) {
 			printf("\nerror reading clock\n\n");
 		}
-		// write each time measurement value into FPGA memory
-		if (tsEnd.tv_nsec > tsStart.tv_nsec) {
-			timesPtr[measurementCnt] = (tsEnd.tv_nsec - tsStart.tv_nsec);
+		phaseBudgetMark(&mapBudget, PH_CLOCK_END);
+
+		// write each time measurement value into FPGA memory, channel 0's
+		// slice is at the start of the array
+		if (tsEnd.tv_nsec > tsStart.tv_nsec &&
+				measurementCnt < fpgaRamArrCount / MAP_CHANNELS) {
+			SCOPE_ENTER(SCOPE_FPGA_WRITE);
+			fpgaRamArrWriteAt(fpgaMemRegs, measurementCnt,
+					(uint32_t)(tsEnd.tv_nsec - tsStart.tv_nsec));
+			SCOPE_EXIT(SCOPE_FPGA_WRITE);
+			flightRecord(&flightRec, FR_EV_REG_WRITE,
+					FPGA_PIO_ARR_OFFSET + measurementCnt * sizeof(uint32_t),
+					(uint32_t)(tsEnd.tv_nsec - tsStart.tv_nsec));
 			++measurementCnt;
 		}
+		phaseBudgetMark(&mapBudget, PH_FPGA_WRITE);
 
+#ifdef USE_UIO_EVENTS
+		// block until the FPGA signals that it has consumed the buffer, the
+		// timeout keeps the old pacing when no interrupt arrives
+		if (uioEventWait(&fpgaEvent, UIO_FPGA_TIMEOUT_MS) == -1) {
+			printf("\nerror waiting for FPGA event\n\n");
+		}
+#else
 		usleep(100000);
+#endif
+		phaseBudgetMark(&mapBudget, PH_WAIT_ON);
 
 		// turn off GPIO1 led three, read-modify-write
 		printf("turning GPIO1 led3 off...\n");
-		*(gpio1BaseAddrPtr) = *(gpio1BaseAddrPtr) & (~(HPS_GPIO1_LED3));
+		phaseBudgetMark(&mapBudget, PH_PRINT_OFF);
+		GPIO1_LEDS_OFF(HPS_GPIO1_LED3);
+		phaseBudgetMark(&mapBudget, PH_LED_OFF);
 
 		usleep(100000);
+		phaseBudgetMark(&mapBudget, PH_WAIT_OFF);
+		phaseBudgetEnd(&mapBudget);
+		flightRecord(&flightRec, FR_EV_CYCLE_END, FR_TASK_MAP,
+				(uint32_t)(tsEnd.tv_nsec - tsStart.tv_nsec));
+#ifdef MAP_DEADLINE
+		if (rtDeadlineCycleEnd(&mapDeadline) != 0) {
+			flightRecord(&flightRec, FR_EV_THROTTLE, FR_TASK_MAP,
+					mapDeadline.overrunsSeen);
+		}
+		if (!mapDeadline.active && mapDeadline.cycles == MAP_DL_CALIBRATE &&
+				rtDeadlineEnter(&mapDeadline, MAP_DL_MARGIN_PCT) != 0) {
+			printf("mapping stays at SCHED_FIFO %d\n", MY_RT_PRIORITY);
+		}
+#endif
 
 	}
+#if MAP_CHANNELS > 1
+	mapChannelsStop();
+#endif
+	phaseBudgetReport(&mapBudget, stdout);
+#ifdef MAP_DEADLINE
+	rtDeadlineReport(&mapDeadline, stdout);
+#endif
 	printf("\nTaskThree exiting...\n\n");
 	pthread_cancel(gThd1IdHolder);
 	pthread_cancel(gThd2IdHolder);
 }
 
+
 int main(void)
 {
 	printf("The main process ID is %d\n", (int)getpid());
 
+	// install the crash dump handler before any thread starts, so every
+	// thread inherits it
+	if ( crashDumpInit(CRASH_DUMP_FILE) == 0 ) {
+		crashDumpAddBudget("mapBudget", &mapBudget);
+#ifdef MAP_DEADLINE
+		crashDumpAddHist("mapDeadline.cpu", &mapDeadline.cpu);
+#endif
+		crashDumpAddWords("gThdLoopCnt", &gThdLoopCnt, 1);
+		crashDumpAddWords("measurementCnt", &measurementCnt, 1);
+		crashDumpAddWords("gpio1Markers.shadow", &gpio1Markers.shadow, 1);
+#ifdef SCOPE_MARKER_LOG
+		crashDumpAddRaw("scopeLog", scopeLog, sizeof(scopeLog));
+#endif
+	}
+
 	// call open to obtain a file descriptor into virtual memory space
 	printf("Attempting to open device file HPS GPIO1...\n\n");
 	fdGpio1 = open( "/dev/mem", ( O_RDWR | O_SYNC ));
@@ -430,18 +659,57 @@ int main(void)
 		printf( "ERROR: mmap() FPGA failed...\n" );
 		close( fdFpgaMem );
 	}
+	gpio1Regs = gpio1Base(gpio1BaseAddrPtr);
+	gpio2Regs = gpio2Base(gpio2BaseAddrPtr);
+	fpgaPioRegs = fpgaPioBase(fpgaPioBaseAddrPtr);
+	fpgaMemRegs = fpgaMemBase(fpgaMemBaseAddrPtr);
+	if( fpgaMemBaseAddrPtr != MAP_FAILED ) {
+		if ( flightRecAttach(&flightRec, SOC_REG_ADDR(fpgaMemBaseAddrPtr, 32,
+				FPGA_FLIGHT_OFFSET), FPGA_FLIGHT_BYTES, 0) != 0 ) {
+			printf("Cannot start the flight recorder.\n");
+		}
+		crashDumpAddWords("fpgaRamArr", fpgaRamArrPtr(fpgaMemRegs),
+				fpgaRamArrCount);
+	}
 
 
 	// set the direction bits for the GPIO1 LEDS by writing to the DDR reg
-	*((uint32_t*)((uint8_t*)gpio1BaseAddrPtr + HPS_GPIO1_DDR_OFF_BYT))
-			= HPS_GPIO1_ALL_ON;
+	gpio1DdrWrite(gpio1Regs, HPS_GPIO1_ALL_ON);
 
 	// set the direction bits for the GPIO2 buttons by writing to the DDR reg
-	*((uint32_t*)((uint8_t*)gpio2BaseAddrPtr + HPS_GPIO2_DDR_OFF_BYT))
-				= HPS_GPIO2_ALL_OFF;
+	gpio2DdrWrite(gpio2Regs, HPS_GPIO2_ALL_OFF);
 
 	// write 0s to correct bits in the dr register to turn the leds off
-	*(gpio1BaseAddrPtr) = *(gpio1BaseAddrPtr) & ~(HPS_GPIO1_ALL_ON);
+	gpio1DrClearBits(gpio1Regs, HPS_GPIO1_ALL_ON);
+
+#ifdef SCOPE_MARKERS
+	// hand the GPIO1 DR register to the scope markers
+	scopeMarkerRegInit(&gpio1Markers,
+			SOC_REG_ADDR(gpio1BaseAddrPtr, 32, HPS_GPIO1_DR_OFF_BYT), 32);
+	scopeMarkerBind(SCOPE_MAP_CALC, "calcModAndMapBits", &gpio1Markers,
+			HPS_GPIO1_LED0);
+	scopeMarkerBind(SCOPE_FPGA_WRITE, "fpgaRamArrWrite", &gpio1Markers,
+			HPS_GPIO1_LED2);
+#endif
+
+#ifdef USE_UIO_EVENTS
+	printf("Attempting to open FPGA event device...\n\n");
+	if ( uioEventOpen(&fpgaEvent, UIO_FPGA_DEV) == -1 ) {
+		printf("Cannot open FPGA event device.\n");
+	}
+#endif
+
+#ifdef USE_GPIO_CDEV
+	// request the four GPIO2 button lines as debounced inputs
+	printf("Attempting to request GPIO2 button lines...\n\n");
+	uint32_t keyLines[4] = { GPIO_CDEV_KEY0_LINE, GPIO_CDEV_KEY0_LINE + 1,
+			GPIO_CDEV_KEY0_LINE + 2, GPIO_CDEV_KEY0_LINE + 3 };
+	fdGpioKeys = gpioCdevRequestInputs(GPIO_CDEV_KEY_CHIP, keyLines, 4,
+			GPIO_CDEV_EDGE_NONE, GPIO_CDEV_DEBOUNCE_US);
+	if ( fdGpioKeys == -1 ) {
+		printf("Cannot request GPIO2 button lines.\n");
+	}
+#endif
 
 	// Create the mutex for coordinating loop count shared variable access
 	// by LED tasks
@@ -464,21 +732,28 @@ int main(void)
 
 	// write 0s to correct bits in the dr register to turn the leds off
 	printf("\nturning all GPIO1 leds off...\n\n");
-	*(gpio1BaseAddrPtr) = *(gpio1BaseAddrPtr) & ~(HPS_GPIO1_ALL_ON);
+	gpio1DrClearBits(gpio1Regs, HPS_GPIO1_ALL_ON);
 
 	// write 0s to the fpga pio register to turn the leds off
 	printf("turning all FPGA leds off...\n\n");
-	*(fpgaPioBaseAddrPtr + FPGA_PIO_LED_OFFSET) =
-	   *(fpgaPioBaseAddrPtr + FPGA_PIO_LED_OFFSET) & (~(FPGA_PIO_LED_ALL_ON));
+	fpgaPioLedClearBits(fpgaPioRegs, FPGA_PIO_LED_ALL_ON);
 
 	// read out the time measurement values written to FPGA memory
-	timesPtr = (uint32_t*)(fpgaMemBaseAddrPtr + FPGA_PIO_ARR_OFFSET);
 	printf("\ntimer measurements (nsec):\n\n");
+	uint64_t mapTimes[FPGA_PIO_ARR_WORDS];
 	int i;
 	for (i = 0; i < measurementCnt; ++i) {
-		printf("interval %d:  %u\n", i, timesPtr[i]);
+		mapTimes[i] = fpgaRamArrReadAt(fpgaMemRegs, i);
+		printf("interval %d:  %u\n", i, (uint32_t)mapTimes[i]);
 	}
 
+	// keep the run in the results store for comparison against a baseline
+	char config[64];
+	snprintf(config, sizeof(config), "MAX_SIZE=%d", MAX_SIZE);
+	benchResultWrite("hwMapCalc", config, mapTimes, measurementCnt);
+
+	flightRecClose(&flightRec);
+
 	printf("\nAttempting to unmap GPIO1 Base Register address...\n\n");
 	if( munmap( (void*)gpio1BaseAddrPtr, PAGE_SIZE ) != 0 ) {
 		printf( "ERROR: munmap() failed...\n" );
@@ -507,6 +782,19 @@ int main(void)
 		return( 1 );
 	}
 
+#ifdef SCOPE_MARKER_LOG
+	scopeMarkerDump(stdout);
+#endif
+
+#ifdef USE_GPIO_CDEV
+	if ( fdGpioKeys != -1 ) {
+		close(fdGpioKeys);
+	}
+#endif
+#ifdef USE_UIO_EVENTS
+	uioEventClose(&fpgaEvent);
+#endif
+
 	printf("main exiting...\n\n");
 
 	return 0;
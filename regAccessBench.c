@@ -0,0 +1,264 @@
+/*****************************************************************************
+ *
+ * regAccessBench.c
+ *
+ * Measures sustained write, read and read-modify-write rates for the
+ * mapped hardware used by the mTenna hardware mapping programs:
+ *
+ * 		gpio1	HPS GPIO1 DR register (LED3 is toggled, so a scope on the
+ * 				LED shows the output rate)
+ * 		pio		FPGA PIO LED register behind the lightweight bridge
+ * 		ram		FPGA on-chip RAM buffer behind the HPS-to-FPGA bridge
+ *
+ * Each target is run at 8, 16, 32 and 64 bit access widths, with the
+ * /dev/mem descriptor opened with and without O_SYNC, and with and without
+ * the register map memory barrier around each access.  The registers are
+ * only run at their native width unless -a is given, as narrower or wider
+ * accesses to the peripheral registers may not be supported by the bus.
+ * On 32 bit ARM a 64 bit access is issued as a pair of word accesses.
+ *
+ * 		regAccessBench [-n iterations] [-t gpio1|pio|ram] [-a] [-s]
+ *
+ * -s runs the same loops against an anonymous page instead of /dev/mem,
+ * which gives the cached memory ceiling and lets the tool run on a host.
+ *
+ * Each loop is timed in REG_CHUNKS equal chunks and every chunk is one
+ * sample of the regAccess.<target>.<op>.<width>.<barrier>.<sync> record
+ * written to the benchResults.h results file.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "socRegMap.h"
+#include "benchResults.h"
+
+#define PAGE_SIZE				4096		// linux page size
+#define DEF_ITERATIONS			1000000
+#define NUM_WIDTHS				4
+#define REG_CHUNKS				64			// timed chunks, one sample each
+
+typedef struct {
+	const char* name;
+	uint32_t physBase;			// page aligned physical base address
+	uint32_t offset;			// byte offset of the accessed word
+	int nativeWidth;			// width of the register in bits
+	uint64_t pattern;			// value written on odd iterations
+} target_t;
+
+static const target_t targets[] = {
+	{ "gpio1", HPS_GPIO1_BASE, HPS_GPIO1_DR_OFF_BYT, 32, HPS_GPIO1_LED3 },
+	{ "pio", HPS_FPGA_SLAVE_BASE + (FPGA_PIO_LED_OFFSET & ~(PAGE_SIZE - 1)),
+			FPGA_PIO_LED_OFFSET & (PAGE_SIZE - 1), 8, FPGA_PIO_LED3 },
+	{ "ram", HPS_FPGA_MEM_BASE, FPGA_PIO_BUF_OFFSET, 0, ~0ULL },
+};
+#define NUM_TARGETS (sizeof(targets) / sizeof(targets[0]))
+
+static const int widths[NUM_WIDTHS] = { 8, 16, 32, 64 };
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// generate write, read and read-modify-write loops for one access width,
+// the barrier variant is a separate loop so the check is not in the loop
+#define BENCH_LOOPS(width) \
+static uint64_t benchWrite##width(volatile void* addr, int iters, \
+		uint64_t pattern, int barrier) \
+{ \
+	volatile uint##width##_t* p = (volatile uint##width##_t*)addr; \
+	uint##width##_t v = (uint##width##_t)pattern; \
+	uint64_t start = nowNs(); \
+	int i; \
+	if (barrier) { \
+		for (i = 0; i < iters; ++i) { \
+			SOC_REG_BARRIER(); \
+			*p = (i & 1) ? v : 0; \
+		} \
+	} \
+	else { \
+		for (i = 0; i < iters; ++i) { \
+			*p = (i & 1) ? v : 0; \
+		} \
+	} \
+	return nowNs() - start; \
+} \
+static uint64_t benchRead##width(volatile void* addr, int iters, \
+		uint64_t pattern, int barrier) \
+{ \
+	volatile uint##width##_t* p = (volatile uint##width##_t*)addr; \
+	uint##width##_t sink = 0; \
+	uint64_t start = nowNs(); \
+	int i; \
+	(void)pattern; \
+	if (barrier) { \
+		for (i = 0; i < iters; ++i) { \
+			sink ^= *p; \
+			SOC_REG_BARRIER(); \
+		} \
+	} \
+	else { \
+		for (i = 0; i < iters; ++i) { \
+			sink ^= *p; \
+		} \
+	} \
+	__asm__ __volatile__("" : : "r"(sink)); \
+	return nowNs() - start; \
+} \
+static uint64_t benchRmw##width(volatile void* addr, int iters, \
+		uint64_t pattern, int barrier) \
+{ \
+	volatile uint##width##_t* p = (volatile uint##width##_t*)addr; \
+	uint##width##_t v = (uint##width##_t)pattern; \
+	uint64_t start = nowNs(); \
+	int i; \
+	if (barrier) { \
+		for (i = 0; i < iters; ++i) { \
+			uint##width##_t cur = *p; \
+			SOC_REG_BARRIER(); \
+			*p = cur ^ v; \
+		} \
+	} \
+	else { \
+		for (i = 0; i < iters; ++i) { \
+			*p = *p ^ v; \
+		} \
+	} \
+	return nowNs() - start; \
+}
+
+BENCH_LOOPS(8)
+BENCH_LOOPS(16)
+BENCH_LOOPS(32)
+BENCH_LOOPS(64)
+
+typedef uint64_t (*benchFn_t)(volatile void*, int, uint64_t, int);
+
+static const benchFn_t benchFns[3][NUM_WIDTHS] = {
+	{ benchWrite8, benchWrite16, benchWrite32, benchWrite64 },
+	{ benchRead8, benchRead16, benchRead32, benchRead64 },
+	{ benchRmw8, benchRmw16, benchRmw32, benchRmw64 },
+};
+static const char* opNames[3] = { "write", "read", "rmw" };
+
+// map the page holding the target, returns MAP_FAILED on failure
+static volatile uint8_t* mapTarget(const target_t* t, int fdMem)
+{
+	if (fdMem == -1) {
+		return (volatile uint8_t*)mmap(NULL, PAGE_SIZE, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+	return (volatile uint8_t*)mmap(NULL, PAGE_SIZE, PROT_READ | PROT_WRITE,
+			MAP_SHARED, fdMem, t->physBase);
+}
+
+static void runTarget(const target_t* t, int fdMem, const char* syncStr,
+		int iters, int allWidths)
+{
+	volatile uint8_t* base = mapTarget(t, fdMem);
+	uint64_t samples[REG_CHUNKS];
+	int chunkIters = (iters < REG_CHUNKS) ? 1 : iters / REG_CHUNKS;
+	int w, op, barrier, c;
+
+	if (base == MAP_FAILED) {
+		printf("ERROR: mmap() %s failed...\n", t->name);
+		return;
+	}
+	// the rates below are over the iterations actually run
+	iters = chunkIters * REG_CHUNKS;
+	for (w = 0; w < NUM_WIDTHS; ++w) {
+		if (t->nativeWidth != 0 && !allWidths &&
+				widths[w] != t->nativeWidth) {
+			continue;
+		}
+		for (barrier = 0; barrier < 2; ++barrier) {
+			for (op = 0; op < 3; ++op) {
+				char name[64], config[64];
+				uint64_t ns = 0;
+				for (c = 0; c < REG_CHUNKS; ++c) {
+					samples[c] = benchFns[op][w](base + t->offset, chunkIters,
+							t->pattern, barrier);
+					ns += samples[c];
+				}
+				snprintf(name, sizeof(name), "regAccess.%s.%s.%d.%s.%s",
+						t->name, opNames[op], widths[w],
+						barrier ? "dmb" : "none", syncStr);
+				snprintf(config, sizeof(config), "chunkOps=%d", chunkIters);
+				benchResultWrite(name, config, samples, REG_CHUNKS);
+				printf("%-6s %-7s %-4s %3d  %-5s  %8.2f Mops/s  %7.1f ns  "
+						"%8.1f MB/s\n", t->name, syncStr,
+						barrier ? "dmb" : "none", widths[w], opNames[op],
+						iters * 1e3 / (double)ns, (double)ns / iters,
+						iters * (widths[w] / 8) * 1e3 / (double)ns);
+			}
+		}
+	}
+	munmap((void*)base, PAGE_SIZE);
+}
+
+int main(int argc, char* argv[])
+{
+	const char* only = NULL;
+	int iters = DEF_ITERATIONS;
+	int allWidths = 0;
+	int simulate = 0;
+	int fdMem;
+	int sync;
+	unsigned t;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:t:ash")) != -1) {
+		switch (opt) {
+		case 'n': iters = atoi(optarg); break;
+		case 't': only = optarg; break;
+		case 'a': allWidths = 1; break;
+		case 's': simulate = 1; break;
+		default:
+			printf("usage: %s [-n iterations] [-t gpio1|pio|ram] [-a] [-s]\n",
+					argv[0]);
+			return 1;
+		}
+	}
+	if (iters <= 0) {
+		return 1;
+	}
+
+	printf("\ntarget sync    bar  bits  op        rate          per op"
+			"      bandwidth\n");
+	for (sync = 1; sync >= 0; --sync) {
+		const char* syncStr = simulate ? "anon" : (sync ? "O_SYNC" : "cached");
+		fdMem = -1;
+		if (!simulate) {
+			fdMem = open("/dev/mem", sync ? (O_RDWR | O_SYNC) : O_RDWR);
+			if (fdMem == -1) {
+				printf("Cannot open device file.\n");
+				return 1;
+			}
+		}
+		for (t = 0; t < NUM_TARGETS; ++t) {
+			if (only == NULL || strcmp(only, targets[t].name) == 0) {
+				runTarget(&targets[t], fdMem, syncStr, iters, allWidths);
+			}
+		}
+		if (fdMem != -1) {
+			close(fdMem);
+		}
+		if (simulate) {
+			break;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,225 @@
+/*****************************************************************************
+ *
+ * rtConfig.h
+ *
+ * Live reconfiguration of RT task parameters without locks on the RT path.
+ *
+ * A configuration is an immutable rtConfig_t.  A control thread publishes a
+ * new one by swapping the domain's current pointer, and each RT task picks
+ * it up at its next cycle boundary by calling rtConfigQuiescent, which
+ * reports that the task holds no reference to an older configuration and
+ * returns the current one.  That is an atomic store and an atomic load, no
+ * lock and no system call.
+ *
+ * Old configurations are reclaimed after a grace period in the style of
+ * quiescent state based RCU: every publish advances the domain epoch, a
+ * retired configuration is freed by rtConfigReclaim once every reader has
+ * passed a cycle boundary in a later epoch.  Readers that stop running
+ * must call rtConfigOffline so they do not hold up reclamation.
+ *
+ * External commands arrive through a small shared memory segment
+ * (RTCFG_SHM_NAME) written by rtConfigCtl and guarded by a sequence
+ * counter, the control thread polls it with rtConfigCmdPoll.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef RT_CONFIG_H
+#define RT_CONFIG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#define RTCFG_MAX_READERS		8
+#define RTCFG_MAX_RETIRED		32
+#define RTCFG_OFFLINE			UINT64_MAX
+#define RTCFG_SHM_NAME			"/rtConfigCmd"
+
+typedef struct {
+	uint32_t periodUs;			// release period
+	int priority;				// RT priority
+	uint32_t passes;			// workload passes per release
+	uint64_t version;			// set by rtConfigPublish
+} rtConfig_t;
+
+typedef struct {
+	rtConfig_t* cfg;
+	uint64_t epoch;				// epoch in which it was replaced
+} rtConfigRetired_t;
+
+typedef struct {
+	rtConfig_t* current;
+	uint64_t epoch;
+	uint64_t readerEpoch[RTCFG_MAX_READERS];
+	int numReaders;
+	rtConfigRetired_t retired[RTCFG_MAX_RETIRED];
+	int numRetired;
+} rtConfigDomain_t;
+
+// command written by rtConfigCtl, seq is odd while the writer is updating
+typedef struct {
+	uint32_t seq;
+	char thread[32];
+	uint32_t periodUs;			// zero leaves the value unchanged
+	int priority;				// zero leaves the value unchanged
+	uint32_t passes;			// zero leaves the value unchanged
+} rtConfigCmd_t;
+
+// initial is copied, so it may live on the caller's stack
+static inline int rtConfigInit(rtConfigDomain_t* dom, const rtConfig_t* initial,
+		int numReaders)
+{
+	int r;
+	memset(dom, 0, sizeof(*dom));
+	dom->current = malloc(sizeof(rtConfig_t));
+	if (dom->current == NULL) {
+		return -1;
+	}
+	*dom->current = *initial;
+	dom->current->version = 0;
+	dom->epoch = 1;
+	dom->numReaders = (numReaders > RTCFG_MAX_READERS) ? RTCFG_MAX_READERS :
+			numReaders;
+	for (r = 0; r < dom->numReaders; ++r) {
+		dom->readerEpoch[r] = RTCFG_OFFLINE;
+	}
+	return 0;
+}
+
+// RT path, call at every cycle boundary, any configuration obtained in an
+// earlier cycle must not be used after this call
+static inline const rtConfig_t* rtConfigQuiescent(rtConfigDomain_t* dom,
+		int reader)
+{
+	__atomic_store_n(&dom->readerEpoch[reader],
+			__atomic_load_n(&dom->epoch, __ATOMIC_SEQ_CST), __ATOMIC_SEQ_CST);
+	return __atomic_load_n(&dom->current, __ATOMIC_SEQ_CST);
+}
+
+// the reader stops taking configurations, e.g. before its thread exits
+static inline void rtConfigOffline(rtConfigDomain_t* dom, int reader)
+{
+	__atomic_store_n(&dom->readerEpoch[reader], RTCFG_OFFLINE,
+			__ATOMIC_SEQ_CST);
+}
+
+// free every retired configuration whose grace period has elapsed,
+// returns the number still waiting
+static inline int rtConfigReclaim(rtConfigDomain_t* dom)
+{
+	uint64_t oldest = RTCFG_OFFLINE;
+	int r, i, kept = 0;
+
+	for (r = 0; r < dom->numReaders; ++r) {
+		uint64_t e = __atomic_load_n(&dom->readerEpoch[r], __ATOMIC_SEQ_CST);
+		if (e < oldest) {
+			oldest = e;
+		}
+	}
+	for (i = 0; i < dom->numRetired; ++i) {
+		if (dom->retired[i].epoch <= oldest) {
+			free(dom->retired[i].cfg);
+		}
+		else {
+			dom->retired[kept++] = dom->retired[i];
+		}
+	}
+	dom->numRetired = kept;
+	return kept;
+}
+
+// control path, publish a copy of next, returns -1 when too many old
+// configurations are still waiting for their grace period
+static inline int rtConfigPublish(rtConfigDomain_t* dom, const rtConfig_t* next)
+{
+	rtConfig_t* cfg;
+	rtConfig_t* old;
+
+	if (dom->numRetired == RTCFG_MAX_RETIRED &&
+			rtConfigReclaim(dom) == RTCFG_MAX_RETIRED) {
+		return -1;
+	}
+	cfg = malloc(sizeof(rtConfig_t));
+	if (cfg == NULL) {
+		return -1;
+	}
+	*cfg = *next;
+	cfg->version = dom->current->version + 1;
+	old = __atomic_exchange_n(&dom->current, cfg, __ATOMIC_SEQ_CST);
+	// readers that report this epoch or later have dropped old
+	dom->retired[dom->numRetired].cfg = old;
+	dom->retired[dom->numRetired].epoch =
+			__atomic_add_fetch(&dom->epoch, 1, __ATOMIC_SEQ_CST);
+	dom->numRetired++;
+	return 0;
+}
+
+// free everything, only once no reader is running
+static inline void rtConfigDestroy(rtConfigDomain_t* dom)
+{
+	int i;
+	for (i = 0; i < dom->numRetired; ++i) {
+		free(dom->retired[i].cfg);
+	}
+	free(dom->current);
+	dom->current = NULL;
+	dom->numRetired = 0;
+}
+
+// map the command segment, creating it if needed, returns NULL on failure
+static inline rtConfigCmd_t* rtConfigCmdMap(void)
+{
+	rtConfigCmd_t* cmd;
+	int fd = shm_open(RTCFG_SHM_NAME, O_RDWR | O_CREAT, 0600);
+	if (fd == -1) {
+		return NULL;
+	}
+	if (ftruncate(fd, sizeof(rtConfigCmd_t)) == -1) {
+		close(fd);
+		return NULL;
+	}
+	cmd = mmap(NULL, sizeof(rtConfigCmd_t), PROT_READ | PROT_WRITE,
+			MAP_SHARED, fd, 0);
+	close(fd);
+	return (cmd == MAP_FAILED) ? NULL : cmd;
+}
+
+// copy out a command newer than *lastSeq, returns 1 when one was read
+static inline int rtConfigCmdPoll(rtConfigCmd_t* shm, uint32_t* lastSeq,
+		rtConfigCmd_t* out)
+{
+	uint32_t seq = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+	if (seq == *lastSeq || (seq & 1)) {
+		return 0;
+	}
+	memcpy(out, shm, sizeof(*out));
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	if (__atomic_load_n(&shm->seq, __ATOMIC_RELAXED) != seq) {
+		return 0;			// torn read, pick it up on the next poll
+	}
+	out->thread[sizeof(out->thread) - 1] = '\0';
+	*lastSeq = seq;
+	return 1;
+}
+
+// writer side used by rtConfigCtl
+static inline void rtConfigCmdPost(rtConfigCmd_t* shm, const char* thread,
+		uint32_t periodUs, int priority, uint32_t passes)
+{
+	uint32_t seq = __atomic_load_n(&shm->seq, __ATOMIC_RELAXED);
+	__atomic_store_n(&shm->seq, seq | 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	snprintf(shm->thread, sizeof(shm->thread), "%s", thread);
+	shm->periodUs = periodUs;
+	shm->priority = priority;
+	shm->passes = passes;
+	__atomic_store_n(&shm->seq, (seq | 1) + 1, __ATOMIC_RELEASE);
+}
+
+#endif // RT_CONFIG_H
@@ -0,0 +1,61 @@
+/*****************************************************************************
+ *
+ * rtConfigCtl.c
+ *
+ * Sends a live reconfiguration command to a running scenarioLauncher
+ * through the rtConfig.h shared memory segment.  The named thread picks up
+ * the new parameters at its next cycle boundary without being restarted.
+ *
+ * 		rtConfigCtl <thread> [period=<usec>] [priority=<n>] [passes=<n>]
+ *
+ * Parameters that are not given keep their current value.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "rtConfig.h"
+
+int main(int argc, char* argv[])
+{
+	rtConfigCmd_t* cmd;
+	uint32_t periodUs = 0;
+	int priority = 0;
+	uint32_t passes = 0;
+	int i;
+
+	if (argc < 3) {
+		printf("usage: %s thread [period=usec] [priority=n] [passes=n]\n",
+				argv[0]);
+		return 1;
+	}
+	for (i = 2; i < argc; ++i) {
+		if (strncmp(argv[i], "period=", 7) == 0) {
+			periodUs = strtoul(argv[i] + 7, NULL, 0);
+		}
+		else if (strncmp(argv[i], "priority=", 9) == 0) {
+			priority = atoi(argv[i] + 9);
+		}
+		else if (strncmp(argv[i], "passes=", 7) == 0) {
+			passes = strtoul(argv[i] + 7, NULL, 0);
+		}
+		else {
+			printf("unknown parameter %s\n", argv[i]);
+			return 1;
+		}
+	}
+
+	cmd = rtConfigCmdMap();
+	if (cmd == NULL) {
+		printf("cannot map %s\n", RTCFG_SHM_NAME);
+		return 1;
+	}
+	rtConfigCmdPost(cmd, argv[1], periodUs, priority, passes);
+	printf("posted command %u for %s\n", cmd->seq, argv[1]);
+	munmap(cmd, sizeof(*cmd));
+	return 0;
+}
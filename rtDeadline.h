@@ -0,0 +1,196 @@
+/*****************************************************************************
+ *
+ * rtDeadline.h
+ *
+ * Runs a periodic task under SCHED_DEADLINE instead of SCHED_FIFO, so a
+ * runaway cycle is throttled when its runtime budget is spent rather than
+ * starving the core, and several tasks on one core each keep the share of
+ * the cpu they were admitted with.
+ *
+ * The task first runs a few cycles under its old policy while
+ * rtDeadlineCycleStart and rtDeadlineCycleEnd measure the thread cpu time
+ * of each cycle.  rtDeadlineEnter then derives the runtime from the worst
+ * cycle plus a margin and switches the calling thread with the overrun
+ * flag set, the kernel sends SIGXCPU each time the task is throttled.  The
+ * handler only counts, rtDeadlineCycleEnd attributes the count to cycles.
+ *
+ * The kernel refuses SCHED_DEADLINE for a thread whose affinity is
+ * narrower than its root domain, a task pinned to one cpu needs an
+ * exclusive cpuset of that cpu, see rtPartition.
+ *
+ * 		rtDeadlineInit(&dl, 100000000ULL);
+ * 		rtDeadlineCycleStart(&dl);		top of every cycle
+ * 		rtDeadlineCycleEnd(&dl);		bottom of every cycle
+ * 		rtDeadlineEnter(&dl, 50);		after the calibration cycles
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef RT_DEADLINE_H
+#define RT_DEADLINE_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "phaseBudget.h"
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE			6
+#endif
+#define RT_DL_FLAG_OVERRUN		0x04		// SCHED_FLAG_DL_OVERRUN
+#define RT_DL_MIN_RUNTIME_NS	1024		// smallest runtime the kernel takes
+
+// struct sched_attr, not every C library declares it
+typedef struct {
+	uint32_t size;
+	uint32_t policy;
+	uint64_t flags;
+	int32_t nice;
+	uint32_t priority;
+	uint64_t runtimeNs;
+	uint64_t deadlineNs;
+	uint64_t periodNs;
+} rtSchedAttr_t;
+
+typedef struct {
+	uint64_t runtimeNs;
+	uint64_t deadlineNs;
+	uint64_t periodNs;
+	int active;					// thread runs under SCHED_DEADLINE
+	int overrunSignal;			// kernel reports throttling with SIGXCPU
+	uint64_t cycleCpuNs;		// thread cpu time at the cycle start
+	uint32_t overrunsSeen;		// rtDlOverruns already attributed
+	uint32_t cycles;
+	uint32_t overrunCycles;		// cycles throttled at least once
+	uint32_t overBudget;		// cycles using more cpu than the runtime
+	phaseHist_t cpu;			// thread cpu time per cycle
+} rtDeadline_t;
+
+static volatile uint32_t rtDlOverruns;
+
+static inline void rtDlOverrunHandler(int sig)
+{
+	(void)sig;
+	__atomic_add_fetch(&rtDlOverruns, 1, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t rtDlThreadCpuNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// deadline and period are both periodNs, SIGXCPU is caught from here on
+// since its default action would kill the process
+static inline void rtDeadlineInit(rtDeadline_t* dl, uint64_t periodNs)
+{
+	struct sigaction sa;
+
+	memset(dl, 0, sizeof(*dl));
+	dl->deadlineNs = periodNs;
+	dl->periodNs = periodNs;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = rtDlOverrunHandler;
+	sa.sa_flags = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	if (sigaction(SIGXCPU, &sa, NULL) == -1) {
+		printf("could not install the SIGXCPU handler\n");
+	}
+}
+
+static inline void rtDeadlineCycleStart(rtDeadline_t* dl)
+{
+	dl->cycleCpuNs = rtDlThreadCpuNs();
+}
+
+// returns the number of times the cycle was throttled
+static inline uint32_t rtDeadlineCycleEnd(rtDeadline_t* dl)
+{
+	uint64_t cpuNs = rtDlThreadCpuNs() - dl->cycleCpuNs;
+	uint32_t overruns = __atomic_load_n(&rtDlOverruns, __ATOMIC_RELAXED);
+	uint32_t fresh = overruns - dl->overrunsSeen;
+
+	phaseHistAdd(&dl->cpu, cpuNs);
+	dl->cycles++;
+	if (dl->active && cpuNs > dl->runtimeNs) {
+		dl->overBudget++;
+	}
+	dl->overrunsSeen = overruns;
+	if (fresh != 0) {
+		dl->overrunCycles++;
+	}
+	return fresh;
+}
+
+// switch the calling thread to SCHED_DEADLINE, the runtime is the worst cpu
+// time per cycle so far plus marginPct, returns -1 and leaves the policy
+// unchanged when the kernel refuses
+static inline int rtDeadlineEnter(rtDeadline_t* dl, int marginPct)
+{
+	rtSchedAttr_t attr;
+	long rc;
+	uint64_t runtime = dl->cpu.maxNs * (100 + marginPct) / 100;
+
+	if (runtime < RT_DL_MIN_RUNTIME_NS) {
+		runtime = RT_DL_MIN_RUNTIME_NS;
+	}
+	if (runtime > dl->deadlineNs) {
+		printf("measured runtime %llu nsec exceeds the %llu nsec deadline\n",
+				(unsigned long long)runtime,
+				(unsigned long long)dl->deadlineNs);
+		return -1;
+	}
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.policy = SCHED_DEADLINE;
+	attr.flags = RT_DL_FLAG_OVERRUN;
+	attr.runtimeNs = runtime;
+	attr.deadlineNs = dl->deadlineNs;
+	attr.periodNs = dl->periodNs;
+	dl->overrunSignal = 1;
+	rc = syscall(SYS_sched_setattr, 0, &attr, 0);
+	if (rc == -1 && errno == EINVAL) {
+		// kernels before 4.16 have no overrun flag, throttling then only
+		// shows as cycles over budget
+		attr.flags = 0;
+		dl->overrunSignal = 0;
+		rc = syscall(SYS_sched_setattr, 0, &attr, 0);
+	}
+	if (rc == -1) {
+		printf("could not switch to SCHED_DEADLINE: %s\n", strerror(errno));
+		return -1;
+	}
+	dl->runtimeNs = runtime;
+	dl->active = 1;
+	printf("\nSCHED_DEADLINE runtime %llu deadline %llu period %llu nsec\n\n",
+			(unsigned long long)dl->runtimeNs,
+			(unsigned long long)dl->deadlineNs,
+			(unsigned long long)dl->periodNs);
+	return 0;
+}
+
+static inline void rtDeadlineReport(const rtDeadline_t* dl, FILE* out)
+{
+	fprintf(out, "\ncpu time per cycle over %u cycles (usec): p50 %.1f p99 "
+			"%.1f max %.1f\n", dl->cycles,
+			phaseHistPercentile(&dl->cpu, 50) / 1e3,
+			phaseHistPercentile(&dl->cpu, 99) / 1e3, dl->cpu.maxNs / 1e3);
+	if (!dl->active) {
+		fprintf(out, "SCHED_DEADLINE not in effect\n");
+		return;
+	}
+	fprintf(out, "SCHED_DEADLINE runtime %.1f usec per %.1f usec period\n",
+			dl->runtimeNs / 1e3, dl->periodNs / 1e3);
+	fprintf(out, "throttled %u times in %u cycles%s, %u cycles over budget\n",
+			dl->overrunsSeen, dl->overrunCycles,
+			dl->overrunSignal ? "" : " (no overrun signal)", dl->overBudget);
+}
+
+#endif // RT_DEADLINE_H
@@ -0,0 +1,815 @@
+/*****************************************************************************
+ *
+ * rtPartition.c
+ *
+ * Keeps the rest of the system off the RT cpus with a cgroup v2 cpuset
+ * partition, per-thread affinity alone does not stop other processes,
+ * kernel threads and interrupts from being scheduled there.
+ *
+ * 		rtPartition [-r cgroupRoot] [-n name] setup rtCpus
+ * 		rtPartition [-r cgroupRoot] [-n name] exec command [args]
+ * 		rtPartition [-r cgroupRoot] [-n name] monitor [seconds]
+ * 		rtPartition [-r cgroupRoot] [-n name] teardown
+ *
+ * setup creates two cgroups below the root (default /sys/fs/cgroup), the
+ * RT partition <name> (default "rt") holding rtCpus and "housekeeping"
+ * holding every other cpu.  The RT cgroup is made an isolated partition,
+ * or a root partition on kernels without isolated partitions, so its cpus
+ * are taken away from every other cgroup and, when isolated, from the
+ * scheduler's load balancing.  Processes in the root cgroup are moved to
+ * housekeeping, every thread that may still run on an RT cpu is given the
+ * housekeeping cpus where the kernel allows it (per-cpu kernel threads do
+ * not), and interrupts and unbound workqueues are steered to housekeeping.
+ *
+ * exec starts a command inside the partition, e.g. the P9 program.
+ *
+ * monitor samples the RT cpus while a run is in progress and reports the
+ * residual activity, interrupts and softirqs that still land on them, the
+ * cpu time not spent idle, and any thread outside the partition that ran
+ * there.  Remaining timer ticks and RCU callbacks need the nohz_full and
+ * rcu_nocbs kernel parameters, which no runtime setting can replace.
+ *
+ * teardown moves the tasks back to the root cgroup and removes both
+ * cgroups.  setup saves what it changes outside the cgroups, the thread
+ * affinities, the interrupt affinities, default_smp_affinity and the
+ * unbound workqueue cpumask, in STATE_DIR/rtPartition.<name>.state, and
+ * teardown writes them back once the partition is gone.  A thread is only
+ * restored when its start time shows it is still the thread that was
+ * moved.  A second setup keeps the state of the first.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+
+#define CGROUP2_MAGIC			0x63677270	// CGROUP2_SUPER_MAGIC
+#define DEF_ROOT				"/sys/fs/cgroup"
+#define DEF_NAME				"rt"
+#define HK_NAME					"housekeeping"
+#define MAX_PATH				512
+#define MAX_DIR					256
+#define MAX_LIST				4096
+#define MAX_COUNTERS			1024		// interrupt and softirq rows
+#define MAX_FOREIGN				256
+#define MONITOR_SAMPLE_US		100000
+#define STATE_DIR				"/run"		// setup state for teardown
+#define WQ_CPUMASK				"/sys/devices/virtual/workqueue/cpumask"
+#define IRQ_DEFAULT_AFFINITY	"/proc/irq/default_smp_affinity"
+
+const char* cgRoot = DEF_ROOT;
+const char* rtName = DEF_NAME;
+char rtDir[MAX_DIR];
+char hkDir[MAX_DIR];
+char statePath[MAX_DIR];
+
+static int writeFile(const char* path, const char* val)
+{
+	int rc = 0;
+	int fd = open(path, O_WRONLY);
+	if (fd == -1) {
+		return -1;
+	}
+	if (write(fd, val, strlen(val)) < 0) {
+		rc = -1;
+	}
+	close(fd);
+	return rc;
+}
+
+static int writeCg(const char* dir, const char* file, const char* val)
+{
+	char path[MAX_PATH];
+	snprintf(path, sizeof(path), "%s/%s", dir, file);
+	if (writeFile(path, val) != 0) {
+		printf("cannot write '%s' to %s: %s\n", val, path, strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+// read a small file, trailing newline removed
+static int readFile(const char* path, char* buf, size_t len)
+{
+	ssize_t n;
+	int fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		return -1;
+	}
+	n = read(fd, buf, len - 1);
+	close(fd);
+	if (n < 0) {
+		return -1;
+	}
+	buf[n] = '\0';
+	buf[strcspn(buf, "\n")] = '\0';
+	return 0;
+}
+
+// cpu list such as "1-3,5" to a cpu set
+static int parseCpuList(const char* list, cpu_set_t* set)
+{
+	char* end;
+	CPU_ZERO(set);
+	while (*list != '\0') {
+		long first = strtol(list, &end, 10), last;
+		if (end == list || first < 0 || first >= CPU_SETSIZE) {
+			return -1;
+		}
+		last = first;
+		if (*end == '-') {
+			list = end + 1;
+			last = strtol(list, &end, 10);
+			if (end == list || last < first || last >= CPU_SETSIZE) {
+				return -1;
+			}
+		}
+		for (; first <= last; ++first) {
+			CPU_SET(first, set);
+		}
+		list = (*end == ',') ? end + 1 : end;
+		if (*end != ',' && *end != '\0') {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+static void formatCpuList(const cpu_set_t* set, char* buf, size_t len)
+{
+	size_t used = 0;
+	int cpu, first;
+	buf[0] = '\0';
+	for (cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+		if (!CPU_ISSET(cpu, set)) {
+			continue;
+		}
+		for (first = cpu; cpu + 1 < CPU_SETSIZE && CPU_ISSET(cpu + 1, set);
+				++cpu) {
+		}
+		used += snprintf(buf + used, (used < len) ? len - used : 0,
+				(first == cpu) ? "%s%d" : "%s%d-%d", used ? "," : "", first,
+				cpu);
+	}
+}
+
+// start time of a thread in clock ticks since boot, field 22 of its stat,
+// zero when the thread is gone
+static unsigned long long threadStartTime(pid_t tid)
+{
+	char path[MAX_PATH], stat[1024];
+	unsigned long long start;
+	char* close;
+	snprintf(path, sizeof(path), "/proc/%d/stat", (int)tid);
+	if (readFile(path, stat, sizeof(stat)) != 0 ||
+			(close = strrchr(stat, ')')) == NULL ||
+			sscanf(close + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u "
+			"%*u %*u %*u %*d %*d %*d %*d %*d %*d %llu", &start) != 1) {
+		return 0;
+	}
+	return start;
+}
+
+static int isCgroup2(const char* path)
+{
+	struct statfs fs;
+	return statfs(path, &fs) == 0 && (uint32_t)fs.f_type == CGROUP2_MAGIC;
+}
+
+// give every thread that may run on an RT cpu the housekeeping cpus, the
+// original affinity of each moved thread is saved to state
+static void moveThreads(const cpu_set_t* rtSet, const cpu_set_t* hkSet,
+		FILE* state)
+{
+	char path[MAX_PATH], list[MAX_LIST];
+	DIR* procDir = opendir("/proc");
+	struct dirent* p;
+	int moved = 0, pinned = 0;
+
+	while (procDir != NULL && (p = readdir(procDir)) != NULL) {
+		DIR* taskDir;
+		struct dirent* t;
+		if (p->d_name[0] < '0' || p->d_name[0] > '9') {
+			continue;
+		}
+		snprintf(path, sizeof(path), "/proc/%s/task", p->d_name);
+		taskDir = opendir(path);
+		while (taskDir != NULL && (t = readdir(taskDir)) != NULL) {
+			cpu_set_t aff, both;
+			pid_t tid = atoi(t->d_name);
+			if (tid <= 0 || sched_getaffinity(tid, sizeof(aff), &aff) != 0) {
+				continue;
+			}
+			CPU_AND(&both, &aff, rtSet);
+			if (CPU_COUNT(&both) == 0) {
+				continue;
+			}
+			CPU_AND(&both, &aff, hkSet);
+			if (CPU_COUNT(&both) == 0) {
+				both = *hkSet;
+			}
+			if (sched_setaffinity(tid, sizeof(both), &both) == 0) {
+				++moved;
+				if (state != NULL) {
+					formatCpuList(&aff, list, sizeof(list));
+					fprintf(state, "thread %d %llu %s\n", (int)tid,
+							threadStartTime(tid), list);
+				}
+			}
+			else {
+				++pinned;			// per-cpu kernel threads refuse
+			}
+		}
+		if (taskDir != NULL) {
+			closedir(taskDir);
+		}
+	}
+	if (procDir != NULL) {
+		closedir(procDir);
+	}
+	printf("threads moved off the RT cpus: %d, left pinned: %d\n", moved,
+			pinned);
+}
+
+// steer interrupts and unbound workqueues to the housekeeping cpus, the
+// settings they replace are saved to state
+static void moveIrqs(const cpu_set_t* hkSet, const char* hkList,
+		FILE* state)
+{
+	char path[MAX_PATH], mask[80], orig[MAX_LIST];
+	DIR* irqDir = opendir("/proc/irq");
+	struct dirent* d;
+	int moved = 0, fixed = 0, cpu;
+	unsigned long long bits = 0;
+
+	while (irqDir != NULL && (d = readdir(irqDir)) != NULL) {
+		if (d->d_name[0] < '0' || d->d_name[0] > '9') {
+			continue;
+		}
+		snprintf(path, sizeof(path), "/proc/irq/%s/smp_affinity_list",
+				d->d_name);
+		if (readFile(path, orig, sizeof(orig)) != 0) {
+			orig[0] = '\0';
+		}
+		if (writeFile(path, hkList) == 0) {
+			++moved;
+			if (state != NULL && orig[0] != '\0') {
+				fprintf(state, "irq %s %s\n", d->d_name, orig);
+			}
+		}
+		else {
+			++fixed;				// per-cpu and managed interrupts
+		}
+	}
+	if (irqDir != NULL) {
+		closedir(irqDir);
+	}
+	// default_smp_affinity takes a hex mask, not a cpu list
+	if (state != NULL && readFile(IRQ_DEFAULT_AFFINITY, orig,
+			sizeof(orig)) == 0) {
+		fprintf(state, "irqdefault %s\n", orig);
+	}
+
+	for (cpu = 0; cpu < 64; ++cpu) {
+		if (CPU_ISSET(cpu, hkSet)) {
+			bits |= 1ULL << cpu;
+		}
+	}
+	snprintf(mask, sizeof(mask), "%llx", bits);
+	if (writeFile(IRQ_DEFAULT_AFFINITY, mask) != 0) {
+		printf("could not change the default interrupt affinity\n");
+	}
+	printf("interrupts moved: %d, fixed: %d\n", moved, fixed);
+
+	if (state != NULL && readFile(WQ_CPUMASK, orig, sizeof(orig)) == 0) {
+		fprintf(state, "wqmask %s\n", orig);
+	}
+	if (writeFile(WQ_CPUMASK, mask) != 0) {
+		printf("could not restrict unbound workqueues\n");
+	}
+}
+
+// move every process listed in one cgroup.procs file to another cgroup
+static int moveProcs(const char* fromDir, const char* toDir, int* failed)
+{
+	char path[MAX_PATH], line[32];
+	int moved = 0;
+	FILE* f;
+
+	*failed = 0;
+	snprintf(path, sizeof(path), "%s/cgroup.procs", fromDir);
+	f = fopen(path, "r");
+	if (f == NULL) {
+		return 0;
+	}
+	snprintf(path, sizeof(path), "%s/cgroup.procs", toDir);
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (writeFile(path, line) == 0) {
+			++moved;
+		}
+		else {
+			++*failed;				// kernel threads stay in the root
+		}
+	}
+	fclose(f);
+	return moved;
+}
+
+static int setupPartition(const char* rtList)
+{
+	char path[MAX_PATH], buf[MAX_LIST], mems[MAX_LIST], hkList[MAX_LIST];
+	cpu_set_t rtSet, allSet, hkSet;
+	FILE* state;
+	int moved, failed;
+
+	if (parseCpuList(rtList, &rtSet) != 0 || CPU_COUNT(&rtSet) == 0) {
+		printf("bad cpu list %s\n", rtList);
+		return -1;
+	}
+	snprintf(path, sizeof(path), "%s/cpuset.cpus.effective", cgRoot);
+	if (readFile(path, buf, sizeof(buf)) != 0 ||
+			parseCpuList(buf, &allSet) != 0) {
+		// the root has no cpuset files until the controller is enabled
+		if (sched_getaffinity(0, sizeof(allSet), &allSet) != 0) {
+			printf("cannot determine the available cpus\n");
+			return -1;
+		}
+	}
+	CPU_AND(&hkSet, &allSet, &rtSet);
+	if (!CPU_EQUAL(&hkSet, &rtSet)) {
+		printf("RT cpus %s are not all available\n", rtList);
+		return -1;
+	}
+	CPU_XOR(&hkSet, &allSet, &rtSet);
+	if (CPU_COUNT(&hkSet) == 0) {
+		printf("no cpu left for housekeeping\n");
+		return -1;
+	}
+	formatCpuList(&hkSet, hkList, sizeof(hkList));
+
+	if (writeCg(cgRoot, "cgroup.subtree_control", "+cpuset") != 0) {
+		return -1;
+	}
+	snprintf(path, sizeof(path), "%s/cpuset.mems.effective", cgRoot);
+	if (readFile(path, mems, sizeof(mems)) != 0) {
+		snprintf(mems, sizeof(mems), "0");
+	}
+	if ((mkdir(hkDir, 0755) != 0 && errno != EEXIST) ||
+			(mkdir(rtDir, 0755) != 0 && errno != EEXIST)) {
+		printf("cannot create cgroups in %s: %s\n", cgRoot, strerror(errno));
+		return -1;
+	}
+	if (writeCg(hkDir, "cpuset.cpus", hkList) != 0 ||
+			writeCg(hkDir, "cpuset.mems", mems) != 0 ||
+			writeCg(rtDir, "cpuset.cpus", rtList) != 0 ||
+			writeCg(rtDir, "cpuset.mems", mems) != 0) {
+		return -1;
+	}
+
+	// isolated partitions also drop the cpus from load balancing, older
+	// kernels only know root partitions
+	snprintf(path, sizeof(path), "%s/cpuset.cpus.partition", rtDir);
+	if (writeFile(path, "isolated") != 0 && writeFile(path, "root") != 0) {
+		printf("cpuset partitions not supported, %s is a plain cpuset\n",
+				rtDir);
+	}
+	if (readFile(path, buf, sizeof(buf)) == 0) {
+		printf("partition %s cpus %s: %s\n", rtName, rtList, buf);
+		if (strstr(buf, "invalid") != NULL) {
+			printf("the partition is not in effect, check that no other "
+					"cgroup claims cpus %s exclusively\n", rtList);
+		}
+	}
+
+	// keep the originals of the first setup when it is run again
+	state = fopen(statePath, "wx");
+	if (state == NULL) {
+		printf("%s: %s, %s\n", statePath, strerror(errno), (errno == EEXIST) ?
+				"keeping the state saved by the earlier setup" :
+				"teardown will not restore affinities");
+	}
+
+	moved = moveProcs(cgRoot, hkDir, &failed);
+	printf("processes moved to %s: %d, left in the root: %d\n", HK_NAME,
+			moved, failed);
+	moveThreads(&rtSet, &hkSet, state);
+	moveIrqs(&hkSet, hkList, state);
+	if (state != NULL) {
+		fclose(state);
+	}
+	printf("\nstart the RT program with: rtPartition -n %s exec program\n",
+			rtName);
+	return 0;
+}
+
+static int execInPartition(char* argv[])
+{
+	char pid[32];
+	snprintf(pid, sizeof(pid), "%d", (int)getpid());
+	if (writeCg(rtDir, "cgroup.procs", pid) != 0) {
+		return -1;
+	}
+	execvp(argv[0], argv);
+	printf("cannot run %s: %s\n", argv[0], strerror(errno));
+	return -1;
+}
+
+// write back what setup saved, run after the partition is gone so the RT
+// cpus are available to the root cgroup again
+static void restoreState(void)
+{
+	char line[MAX_LIST], path[MAX_PATH], list[MAX_LIST], name[32];
+	unsigned long long start;
+	int threads = 0, irqs = 0, stale = 0, tid;
+	cpu_set_t aff;
+	FILE* state = fopen(statePath, "r");
+
+	if (state == NULL) {
+		printf("no saved state in %s, affinities are left as they are\n",
+				statePath);
+		return;
+	}
+	while (fgets(line, sizeof(line), state) != NULL) {
+		if (sscanf(line, "thread %d %llu %4095s", &tid, &start, list) == 3) {
+			if (threadStartTime(tid) != start || start == 0 ||
+					parseCpuList(list, &aff) != 0 ||
+					sched_setaffinity(tid, sizeof(aff), &aff) != 0) {
+				++stale;			// exited, or the tid was reused
+			}
+			else {
+				++threads;
+			}
+		}
+		else if (sscanf(line, "irq %31s %4095s", name, list) == 2) {
+			snprintf(path, sizeof(path), "/proc/irq/%s/smp_affinity_list",
+					name);
+			if (writeFile(path, list) == 0) {
+				++irqs;
+			}
+		}
+		else if (sscanf(line, "irqdefault %4095s", list) == 1) {
+			writeFile(IRQ_DEFAULT_AFFINITY, list);
+		}
+		else if (sscanf(line, "wqmask %4095s", list) == 1) {
+			writeFile(WQ_CPUMASK, list);
+		}
+	}
+	fclose(state);
+	unlink(statePath);
+	printf("affinities restored: %d threads (%d gone), %d interrupts\n",
+			threads, stale, irqs);
+}
+
+static int teardownPartition(void)
+{
+	int moved, failed;
+	moved = moveProcs(rtDir, cgRoot, &failed);
+	moved += moveProcs(hkDir, cgRoot, &failed);
+	printf("processes moved back to the root: %d\n", moved);
+	writeCg(rtDir, "cpuset.cpus.partition", "member");
+	if (rmdir(rtDir) != 0 || rmdir(hkDir) != 0) {
+		printf("cannot remove the cgroups: %s\n", strerror(errno));
+		return -1;
+	}
+	restoreState();
+	return 0;
+}
+
+// per-cpu counters of /proc/interrupts or /proc/softirqs, summed over the
+// RT cpus for every row
+typedef struct {
+	int numRows;
+	char names[MAX_COUNTERS][48];
+	uint64_t counts[MAX_COUNTERS];
+} counters_t;
+
+static void readCounters(const char* path, const cpu_set_t* rtSet,
+		counters_t* c)
+{
+	int cols[CPU_SETSIZE];
+	int numCols = 0;
+	char* line = NULL;
+	size_t len = 0;
+	FILE* f = fopen(path, "r");
+
+	c->numRows = 0;
+	if (f == NULL || getline(&line, &len, f) == -1) {
+		if (f != NULL) {
+			fclose(f);
+		}
+		return;
+	}
+	// header names the cpu of each column
+	{
+		char* p = line;
+		while ((p = strstr(p, "CPU")) != NULL && numCols < CPU_SETSIZE) {
+			cols[numCols++] = atoi(p + 3);
+			p += 3;
+		}
+	}
+	while (getline(&line, &len, f) != -1 && c->numRows < MAX_COUNTERS) {
+		char* p = strchr(line, ':');
+		char* name = line;
+		uint64_t sum = 0;
+		int col;
+		if (p == NULL) {
+			continue;
+		}
+		*p++ = '\0';
+		while (*name == ' ') {
+			++name;
+		}
+		for (col = 0; col < numCols; ++col) {
+			char* end;
+			uint64_t v = strtoull(p, &end, 10);
+			if (end == p) {
+				break;
+			}
+			if (CPU_ISSET(cols[col], rtSet)) {
+				sum += v;
+			}
+			p = end;
+		}
+		// keep the description of numbered interrupts
+		while (*p == ' ') {
+			++p;
+		}
+		p[strcspn(p, "\n")] = '\0';
+		snprintf(c->names[c->numRows], sizeof(c->names[0]), "%s %s", name,
+				p);
+		c->counts[c->numRows++] = sum;
+	}
+	free(line);
+	fclose(f);
+}
+
+static void reportCounters(const char* what, const counters_t* before,
+		const counters_t* after)
+{
+	int i, j, shown = 0;
+	for (i = 0; i < after->numRows; ++i) {
+		for (j = 0; j < before->numRows; ++j) {
+			if (strcmp(before->names[j], after->names[i]) == 0) {
+				break;
+			}
+		}
+		uint64_t delta = after->counts[i] -
+				((j < before->numRows) ? before->counts[j] : 0);
+		if (delta != 0) {
+			if (shown++ == 0) {
+				printf("\n%s on the RT cpus:\n", what);
+			}
+			printf("  %10llu  %s\n", (unsigned long long)delta,
+					after->names[i]);
+		}
+	}
+	if (shown == 0) {
+		printf("\nno %s on the RT cpus\n", what);
+	}
+}
+
+// busy and total jiffies of every RT cpu from /proc/stat
+static void readCpuTimes(const cpu_set_t* rtSet, uint64_t* busy,
+		uint64_t* total)
+{
+	char line[512];
+	FILE* f = fopen("/proc/stat", "r");
+	memset(busy, 0, CPU_SETSIZE * sizeof(uint64_t));
+	memset(total, 0, CPU_SETSIZE * sizeof(uint64_t));
+	while (f != NULL && fgets(line, sizeof(line), f) != NULL) {
+		unsigned long long v[8] = { 0 };
+		int cpu;
+		if (strncmp(line, "cpu", 3) != 0 || line[3] < '0' || line[3] > '9') {
+			continue;
+		}
+		if (sscanf(line + 3, "%d %llu %llu %llu %llu %llu %llu %llu %llu",
+				&cpu, &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6],
+				&v[7]) < 5 || cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, rtSet)) {
+			continue;
+		}
+		total[cpu] = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6] + v[7];
+		busy[cpu] = total[cpu] - v[3] - v[4];
+	}
+	if (f != NULL) {
+		fclose(f);
+	}
+}
+
+typedef struct {
+	pid_t tid;
+	char comm[32];
+	uint64_t cpuTicks;			// utime + stime at the last sample
+	uint32_t hits;				// samples in which it ran on an RT cpu
+} foreign_t;
+
+foreign_t foreign[MAX_FOREIGN];
+int numForeign;
+
+static int inList(const pid_t* list, int n, pid_t tid)
+{
+	int i;
+	for (i = 0; i < n; ++i) {
+		if (list[i] == tid) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// note threads outside the partition that consumed cpu time on an RT cpu
+static void sampleThreads(const cpu_set_t* rtSet)
+{
+	static pid_t members[MAX_LIST];
+	char path[MAX_PATH], stat[1024];
+	int numMembers = 0;
+	DIR* procDir;
+	struct dirent* p;
+	FILE* f;
+
+	snprintf(path, sizeof(path), "%s/cgroup.threads", rtDir);
+	f = fopen(path, "r");
+	while (f != NULL && numMembers < MAX_LIST &&
+			fscanf(f, "%d", &members[numMembers]) == 1) {
+		++numMembers;
+	}
+	if (f != NULL) {
+		fclose(f);
+	}
+
+	procDir = opendir("/proc");
+	while (procDir != NULL && (p = readdir(procDir)) != NULL) {
+		DIR* taskDir;
+		struct dirent* t;
+		if (p->d_name[0] < '0' || p->d_name[0] > '9') {
+			continue;
+		}
+		snprintf(path, sizeof(path), "/proc/%s/task", p->d_name);
+		taskDir = opendir(path);
+		while (taskDir != NULL && (t = readdir(taskDir)) != NULL) {
+			unsigned long long utime, stime;
+			char* close;
+			char comm[32];
+			int cpu, i;
+			pid_t tid = atoi(t->d_name);
+			if (tid <= 0 || inList(members, numMembers, tid)) {
+				continue;
+			}
+			snprintf(path, sizeof(path), "/proc/%.16s/task/%.16s/stat", p->d_name,
+					t->d_name);
+			if (readFile(path, stat, sizeof(stat)) != 0 ||
+					(close = strrchr(stat, ')')) == NULL) {
+				continue;
+			}
+			// fields 14, 15 and 39 (processor), fields 26 to 37 are 12 values
+			if (sscanf(close + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u "
+					"%*u %llu %llu %*d %*d %*d %*d %*d %*d %*u %*u %*d %*u "
+					"%*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*u %*d "
+					"%d", &utime, &stime, &cpu) != 3 || cpu < 0 ||
+					cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, rtSet)) {
+				continue;
+			}
+			snprintf(comm, sizeof(comm), "%.*s",
+					(int)(close - strchr(stat, '(') - 1), strchr(stat, '(') + 1);
+			for (i = 0; i < numForeign && foreign[i].tid != tid; ++i) {
+			}
+			if (i == numForeign) {
+				if (numForeign == MAX_FOREIGN) {
+					continue;
+				}
+				foreign[i].tid = tid;
+				snprintf(foreign[i].comm, sizeof(foreign[i].comm), "%s", comm);
+				foreign[i].cpuTicks = utime + stime;
+				foreign[i].hits = 0;
+				++numForeign;
+				continue;
+			}
+			if (utime + stime != foreign[i].cpuTicks) {
+				foreign[i].hits++;
+				foreign[i].cpuTicks = utime + stime;
+			}
+		}
+		if (taskDir != NULL) {
+			closedir(taskDir);
+		}
+	}
+	if (procDir != NULL) {
+		closedir(procDir);
+	}
+}
+
+static int monitorPartition(int seconds)
+{
+	static counters_t irqBefore, irqAfter, softBefore, softAfter;
+	static uint64_t busy0[CPU_SETSIZE], total0[CPU_SETSIZE];
+	static uint64_t busy1[CPU_SETSIZE], total1[CPU_SETSIZE];
+	char path[MAX_PATH], buf[MAX_LIST];
+	cpu_set_t rtSet;
+	struct timespec sample = { 0, MONITOR_SAMPLE_US * 1000L };
+	int i, cpu, shown = 0;
+	int samples = seconds * (1000000 / MONITOR_SAMPLE_US);
+
+	snprintf(path, sizeof(path), "%s/cpuset.cpus.effective", rtDir);
+	if (readFile(path, buf, sizeof(buf)) != 0 ||
+			parseCpuList(buf, &rtSet) != 0 || CPU_COUNT(&rtSet) == 0) {
+		printf("no partition %s, run setup first\n", rtDir);
+		return -1;
+	}
+	printf("monitoring cpus %s for %d seconds...\n", buf, seconds);
+
+	readCounters("/proc/interrupts", &rtSet, &irqBefore);
+	readCounters("/proc/softirqs", &rtSet, &softBefore);
+	readCpuTimes(&rtSet, busy0, total0);
+	for (i = 0; i < samples; ++i) {
+		sampleThreads(&rtSet);
+		nanosleep(&sample, NULL);
+	}
+	readCounters("/proc/interrupts", &rtSet, &irqAfter);
+	readCounters("/proc/softirqs", &rtSet, &softAfter);
+	readCpuTimes(&rtSet, busy1, total1);
+
+	printf("\n");
+	for (cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+		if (CPU_ISSET(cpu, &rtSet) && total1[cpu] > total0[cpu]) {
+			printf("cpu%d busy %.1f%%\n", cpu, 100.0 *
+					(busy1[cpu] - busy0[cpu]) / (total1[cpu] - total0[cpu]));
+		}
+	}
+	reportCounters("interrupts", &irqBefore, &irqAfter);
+	reportCounters("softirqs", &softBefore, &softAfter);
+	for (i = 0; i < numForeign; ++i) {
+		if (foreign[i].hits == 0) {
+			continue;
+		}
+		if (shown++ == 0) {
+			printf("\nthreads outside the partition running on the RT cpus "
+					"(samples):\n");
+		}
+		printf("  %8d  %-20s %u\n", (int)foreign[i].tid, foreign[i].comm,
+				foreign[i].hits);
+	}
+	if (shown == 0) {
+		printf("\nno thread outside the partition ran on the RT cpus\n");
+	}
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* cmd;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "+r:n:h")) != -1) {
+		switch (opt) {
+		case 'r': cgRoot = optarg; break;
+		case 'n': rtName = optarg; break;
+		default:
+			optind = argc;
+			break;
+		}
+	}
+	if (optind >= argc) {
+		printf("usage: %s [-r cgroupRoot] [-n name] setup rtCpus\n"
+				"       %s [-r cgroupRoot] [-n name] exec command [args]\n"
+				"       %s [-r cgroupRoot] [-n name] monitor [seconds]\n"
+				"       %s [-r cgroupRoot] [-n name] teardown\n",
+				argv[0], argv[0], argv[0], argv[0]);
+		return 1;
+	}
+	if (!isCgroup2(cgRoot)) {
+		printf("%s is not a cgroup v2 mount\n", cgRoot);
+		return 1;
+	}
+	snprintf(rtDir, sizeof(rtDir), "%s/%s", cgRoot, rtName);
+	snprintf(hkDir, sizeof(hkDir), "%s/%s", cgRoot, HK_NAME);
+	snprintf(statePath, sizeof(statePath), "%s/rtPartition.%s.state",
+			STATE_DIR, rtName);
+
+	cmd = argv[optind];
+	if (strcmp(cmd, "setup") == 0 && optind + 1 < argc) {
+		return setupPartition(argv[optind + 1]) ? 1 : 0;
+	}
+	if (strcmp(cmd, "exec") == 0 && optind + 1 < argc) {
+		return execInPartition(&argv[optind + 1]) ? 1 : 0;
+	}
+	if (strcmp(cmd, "monitor") == 0) {
+		return monitorPartition((optind + 1 < argc) ?
+				atoi(argv[optind + 1]) : 10) ? 1 : 0;
+	}
+	if (strcmp(cmd, "teardown") == 0) {
+		return teardownPartition() ? 1 : 0;
+	}
+	printf("unknown command %s\n", cmd);
+	return 1;
+}
@@ -6,6 +6,22 @@
  * Call gettimeofday() repeatedly to demonstrate the effects of paging with
  * different scheduling polices and process priorities.
  *
+ * The work done between time measurements is selected from the synthetic
+ * workload kernels in workloadKernels.h:
+ *
+ * 		rtPrioTests [kernel] [workingSetBytes] [passes] [durationUs]
+ *
+ * where kernel is one of memset, triad, random, int, fp, branchy or
+ * syscall.  A non-zero durationUs repeats passes until that much time has
+ * elapsed instead of running a fixed number of passes.  The default, a
+ * single memset pass over buffSize ints, runs on a buffer that is not
+ * touched beforehand, so like the original zeroing loop over a stack
+ * buffer its first pass shows the page faults.  The other kernels run on
+ * a pre-touched heap buffer.
+ *
+ * The delay of each of the 100 loops, the time beyond delVal, is appended
+ * to the benchResults.h results file as an rtPrio.<kernel> record.
+ *
  * Original code by Shawn Quinn
  * Created Date:  12/18/2014
  *
@@ -15,6 +31,9 @@
 #include <stdio.h>
 // add the following to allow changing the default scheduler policy
 #include <sched.h>
+#include <stdlib.h>
+#include "workloadKernels.h"
+#include "benchResults.h"
 
 //#define MY_RT_PRIORITY 0 /* Lowest possible */
 #define MY_RT_PRIORITY 99 /* Highest possible */
@@ -23,8 +42,40 @@
 const int delVal = 25000;	// 25 msec delay parameter
 const int buffSize = 40000; // big enough to force paging
 
-int main(void)
+int main(int argc, char* argv[])
 {
+	workload_t wk;
+	int kind = WK_MEMSET;
+	size_t workingSet = buffSize * sizeof(int);
+	uint32_t passes = 1;
+	uint32_t durationUs = 0;
+	uint64_t delayNs[100];
+	char name[32], config[96];
+	if (argc > 1) {
+		kind = workloadLookup(argv[1]);
+		if (kind < 0) {
+			printf("unknown workload %s\n", argv[1]);
+			return 1;
+		}
+	}
+	if (argc > 2) {
+		workingSet = strtoul(argv[2], NULL, 0);
+	}
+	if (argc > 3) {
+		passes = strtoul(argv[3], NULL, 0);
+	}
+	if (argc > 4) {
+		durationUs = strtoul(argv[4], NULL, 0);
+	}
+	if ((kind == WK_MEMSET ?
+			workloadAlloc(&wk, kind, workingSet, passes, durationUs) :
+			workloadInit(&wk, kind, workingSet, passes, durationUs)) != 0) {
+		printf("could not allocate workload buffer\n");
+		return 1;
+	}
+	printf("workload %s, working set %zu bytes, %u passes\n",
+			workloadNames[kind], wk.workingSetBytes, wk.passes);
+
 #ifdef RUN_AS_RT
 	int rc, old_scheduler_policy;
 	struct sched_param my_params;
@@ -37,26 +88,31 @@ int main(void)
 		printf("could not change scheduler policy\n");
 #endif
     int i = 0;
-    int j = 0;
-    int dummyBuff[buffSize];
     struct timeval tv1, tv2, tvdel;
     tvdel.tv_sec = 0;
     tvdel.tv_usec = delVal;
     for(i = 0; i < 100; ++i)
     {
         gettimeofday(&tv1, NULL);
-        for(j = 0; j < buffSize; ++j)
-        {
-            dummyBuff[j] = 0;   // give process something to chew on
-        }
+        workloadRun(&wk);   // give process something to chew on
         select(0, NULL, NULL, NULL, &tvdel);	// delay...
         gettimeofday(&tv2, NULL);
         printf("first time value = %d\n", (int)tv1.tv_usec);
         printf("second time value = %d\n", (int)tv2.tv_usec);
         printf("delay (msec) = %d\n", (int)(tv2.tv_usec - tv1.tv_usec) - delVal);
+        long elapsedUs = (tv2.tv_sec - tv1.tv_sec) * 1000000L +
+                (tv2.tv_usec - tv1.tv_usec);
+        delayNs[i] = (elapsedUs > delVal) ?
+                (uint64_t)(elapsedUs - delVal) * 1000 : 0;
         tvdel.tv_sec = 0;
         tvdel.tv_usec = delVal;
     }
 
+    snprintf(name, sizeof(name), "rtPrio.%s", workloadNames[kind]);
+    snprintf(config, sizeof(config), "workingSet=%zu passes=%u durationUs=%u "
+            "prefault=%s", wk.workingSetBytes, wk.passes, wk.durationUs,
+            (kind == WK_MEMSET) ? "no" : "yes");
+    benchResultWrite(name, config, delayNs, 100);
+    workloadFree(&wk);
     return 0;
 }
@@ -0,0 +1,598 @@
+/*****************************************************************************
+ *
+ * scenarioLauncher.c
+ *
+ * Runs a set of periodic threads described by a scenario file, so periods,
+ * priorities, affinities and workloads can be swept without editing macros
+ * and rebuilding on the board.
+ *
+ * Scenario file format, one directive per line, '#' starts a comment:
+ *
+ * 		duration <seconds>			run time, default 10
+ * 		mlockall <yes|no>			lock memory before starting, default yes
+ * 		results <name>				store each thread's wakeup latency in the
+ * 									results file as <name>.<thread>
+ * 		flight <path>				keep release, completion and overrun
+ * 									events in a flight recorder ring file,
+ * 									decode with flightDecode -f <path>
+ * 		crash <path>				on a fatal signal append every thread's
+ * 									histograms to a crash dump file
+ * 		thread key=value ...		one periodic thread, keys:
+ * 			name=<text>				thread name (required)
+ * 			period=<usec>			release period (required)
+ * 			policy=<fifo|rr|other>	scheduling policy, default fifo
+ * 			priority=<1..99>		RT priority, default 50
+ * 			cpu=<n>					pin to cpu n, default not pinned
+ * 			workload=<kind>			memset, triad, random, int, fp, branchy,
+ * 									syscall, led, map or none
+ * 			ws=<bytes>				working set, default 4096
+ * 			passes=<n>				passes per release, default 1
+ * 			mask=<hex>				GPIO1 DR bits toggled by the led workload
+ * 			count=<n>				stop after n releases, default unlimited
+ *
+ * Each thread is released on an absolute CLOCK_MONOTONIC schedule with
+ * clock_nanosleep, and the wakeup latency (actual minus planned release)
+ * and the execution time of every release are recorded and reported.
+ *
+ * The led workload maps HPS GPIO1 through /dev/mem, and the map workload
+ * calls calcModAndMapBits when built with -DHAVE_HW_MAP next to
+ * hardwareMapSoC.h.
+ *
+ * While the scenario runs, period, priority and passes of any thread can be
+ * changed with rtConfigCtl.  The launcher's control thread publishes the
+ * new parameters through rtConfig.h and the thread adopts them at its next
+ * release, without a restart and without taking a lock.
+ *
+ * 		scenarioLauncher p9Default.scenario
+ * 		rtConfigCtl taskThree period=100000
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "socRegMap.h"
+#include "workloadKernels.h"
+#include "phaseBudget.h"
+#include "benchResults.h"
+#include "rtConfig.h"
+#include "flightRecorder.h"
+#include "crashDump.h"
+#ifdef HAVE_HW_MAP
+#include "hardwareMapSoC.h"
+#endif
+
+#define PAGE_SIZE				4096		// linux page size
+#define MAX_THREADS				16
+#define MAX_LINE				512
+#define MAX_LAT_SAMPLES			100000		// wakeup samples kept per thread
+#define CONTROL_POLL_US			100000		// rtConfigCtl command poll period
+#define WK_LED					(WK_NUM_KERNELS)		// extra workloads
+#define WK_MAP					(WK_NUM_KERNELS + 1)
+#define WK_NONE					(WK_NUM_KERNELS + 2)
+
+typedef struct {
+	char name[32];
+	uint32_t periodUs;
+	int policy;
+	int priority;
+	int cpu;					// -1 when not pinned
+	int workload;
+	size_t workingSet;
+	uint32_t passes;
+	uint32_t ledMask;
+	uint32_t count;				// releases to run, zero for unlimited
+
+	// run state
+	pthread_t tid;
+	rtConfigDomain_t cfgDom;	// live parameters, one reader, the thread
+	workload_t wk;
+	phaseHist_t wakeup;
+	phaseHist_t exec;
+	char dumpNames[2][48];		// crash dump region names of the histograms
+	uint64_t* latSamples;
+	uint32_t numSamples;
+	uint32_t overruns;			// releases that started after the next one
+} scnThread_t;
+
+typedef struct {
+	uint32_t durationSec;
+	int lockMemory;
+	char resultsName[64];
+	char flightPath[128];
+	char crashPath[128];
+	int numThreads;
+	scnThread_t threads[MAX_THREADS];
+} scenario_t;
+
+scenario_t scn;
+volatile int stopAll = 0;
+flightRec_t flightRec;			// disabled unless the scenario names a ring
+volatile uint32_t* gpio1BaseAddrPtr = NULL;
+gpio1Base_t gpio1Regs;			// typed handle of the GPIO1 mapping
+#ifdef HAVE_HW_MAP
+uint32_t modBuff[MAX_SIZE];
+#endif
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int parseWorkload(const char* name, int lineNo)
+{
+	int workload;
+	if (strcmp(name, "led") == 0) {
+		return WK_LED;
+	}
+	if (strcmp(name, "map") == 0) {
+#ifdef HAVE_HW_MAP
+		return WK_MAP;
+#else
+		// would run nothing and report the latencies of an idle task
+		printf("line %d: workload map needs calcModAndMapBits, build with "
+				"-DHAVE_HW_MAP\n", lineNo);
+		return -1;
+#endif
+	}
+	if (strcmp(name, "none") == 0) {
+		return WK_NONE;
+	}
+	workload = workloadLookup(name);
+	if (workload < 0) {
+		printf("line %d: unknown workload %s\n", lineNo, name);
+	}
+	return workload;
+}
+
+// parse the key=value pairs of a thread directive
+static int parseThread(scnThread_t* t, char* args, int lineNo)
+{
+	char* save = NULL;
+	char* tok;
+
+	memset(t, 0, sizeof(*t));
+	t->policy = SCHED_FIFO;
+	t->priority = 50;
+	t->cpu = -1;
+	t->workload = WK_NONE;
+	t->workingSet = 4096;
+	t->passes = 1;
+	for (tok = strtok_r(args, " \t", &save); tok != NULL;
+			tok = strtok_r(NULL, " \t", &save)) {
+		char* val = strchr(tok, '=');
+		if (val == NULL) {
+			printf("line %d: expected key=value, got %s\n", lineNo, tok);
+			return -1;
+		}
+		*val++ = '\0';
+		if (strcmp(tok, "name") == 0) {
+			snprintf(t->name, sizeof(t->name), "%s", val);
+		}
+		else if (strcmp(tok, "period") == 0) {
+			t->periodUs = strtoul(val, NULL, 0);
+		}
+		else if (strcmp(tok, "policy") == 0) {
+			t->policy = (strcmp(val, "rr") == 0) ? SCHED_RR :
+					(strcmp(val, "other") == 0) ? SCHED_OTHER : SCHED_FIFO;
+		}
+		else if (strcmp(tok, "priority") == 0) {
+			t->priority = atoi(val);
+		}
+		else if (strcmp(tok, "cpu") == 0) {
+			t->cpu = atoi(val);
+		}
+		else if (strcmp(tok, "workload") == 0) {
+			t->workload = parseWorkload(val, lineNo);
+			if (t->workload < 0) {
+				return -1;
+			}
+		}
+		else if (strcmp(tok, "ws") == 0) {
+			t->workingSet = strtoul(val, NULL, 0);
+		}
+		else if (strcmp(tok, "passes") == 0) {
+			t->passes = strtoul(val, NULL, 0);
+		}
+		else if (strcmp(tok, "mask") == 0) {
+			t->ledMask = strtoul(val, NULL, 16);
+		}
+		else if (strcmp(tok, "count") == 0) {
+			t->count = strtoul(val, NULL, 0);
+		}
+		else {
+			printf("line %d: unknown thread key %s\n", lineNo, tok);
+			return -1;
+		}
+	}
+	if (t->name[0] == '\0' || t->periodUs == 0) {
+		printf("line %d: thread needs name and period\n", lineNo);
+		return -1;
+	}
+	return 0;
+}
+
+static int loadScenario(const char* path, scenario_t* s)
+{
+	char line[MAX_LINE];
+	int lineNo = 0;
+	FILE* f = fopen(path, "r");
+
+	memset(s, 0, sizeof(*s));
+	s->durationSec = 10;
+	s->lockMemory = 1;
+	if (f == NULL) {
+		printf("cannot open scenario %s\n", path);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f) != NULL) {
+		char* p;
+		++lineNo;
+		line[strcspn(line, "#\n")] = '\0';
+		for (p = line; *p == ' ' || *p == '\t'; ++p) {
+		}
+		if (*p == '\0') {
+			continue;
+		}
+		if (strncmp(p, "duration ", 9) == 0) {
+			s->durationSec = strtoul(p + 9, NULL, 0);
+		}
+		else if (strncmp(p, "mlockall ", 9) == 0) {
+			s->lockMemory = (strncmp(p + 9, "no", 2) != 0);
+		}
+		else if (strncmp(p, "results ", 8) == 0) {
+			sscanf(p + 8, "%63s", s->resultsName);
+		}
+		else if (strncmp(p, "flight ", 7) == 0) {
+			sscanf(p + 7, "%127s", s->flightPath);
+		}
+		else if (strncmp(p, "crash ", 6) == 0) {
+			sscanf(p + 6, "%127s", s->crashPath);
+		}
+		else if (strncmp(p, "thread ", 7) == 0) {
+			if (s->numThreads == MAX_THREADS) {
+				printf("line %d: too many threads\n", lineNo);
+				fclose(f);
+				return -1;
+			}
+			if (parseThread(&s->threads[s->numThreads], p + 7, lineNo) != 0) {
+				fclose(f);
+				return -1;
+			}
+			s->numThreads++;
+		}
+		else {
+			printf("line %d: unknown directive %s\n", lineNo, p);
+			fclose(f);
+			return -1;
+		}
+	}
+	fclose(f);
+	return 0;
+}
+
+static void runWorkload(scnThread_t* t, uint32_t release)
+{
+	switch (t->workload) {
+	case WK_LED:
+		if (gpio1BaseAddrPtr != NULL) {
+			if (release & 1) {
+				gpio1DrSetBits(gpio1Regs, t->ledMask);
+			}
+			else {
+				gpio1DrClearBits(gpio1Regs, t->ledMask);
+			}
+		}
+		break;
+	case WK_MAP:
+#ifdef HAVE_HW_MAP
+		calcModAndMapBits(modBuff);
+#endif
+		break;
+	case WK_NONE:
+		break;
+	default:
+		workloadRun(&t->wk);
+		break;
+	}
+}
+
+void* periodicTask(void* arg)
+{
+	scnThread_t* t = (scnThread_t*)arg;
+	const rtConfig_t* cfg;
+	struct sched_param my_params;
+	struct timespec next;
+	uint64_t planned, start, end;
+	uint32_t release;
+	uint32_t task = (uint32_t)(t - scn.threads);
+	int appliedPrio = t->priority;
+
+	crashDumpThreadInit();
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	for (release = 0; !stopAll && (t->count == 0 || release < t->count);
+			++release) {
+		// cycle boundary, pick up any newly published parameters
+		cfg = rtConfigQuiescent(&t->cfgDom, 0);
+		if (cfg->priority != appliedPrio && t->policy != SCHED_OTHER) {
+			my_params.sched_priority = cfg->priority;
+			pthread_setschedparam(pthread_self(), t->policy, &my_params);
+			appliedPrio = cfg->priority;
+		}
+		t->wk.passes = cfg->passes ? cfg->passes : 1;
+
+		next.tv_nsec += (long)cfg->periodUs * 1000;
+		while (next.tv_nsec >= 1000000000L) {
+			next.tv_nsec -= 1000000000L;
+			next.tv_sec++;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+		planned = (uint64_t)next.tv_sec * 1000000000ULL + next.tv_nsec;
+		start = nowNs();
+		flightRecord(&flightRec, FR_EV_CYCLE_START, task, release);
+		runWorkload(t, release);
+		end = nowNs();
+		flightRecord(&flightRec, FR_EV_CYCLE_END, task, end - start);
+
+		phaseHistAdd(&t->wakeup, start - planned);
+		phaseHistAdd(&t->exec, end - start);
+		if (t->latSamples != NULL && t->numSamples < MAX_LAT_SAMPLES) {
+			t->latSamples[t->numSamples++] = start - planned;
+		}
+		// skip releases already missed instead of running them back to back
+		if (end > planned + (uint64_t)cfg->periodUs * 1000) {
+			t->overruns++;
+			flightRecord(&flightRec, FR_EV_OVERRUN, task,
+					end - planned - (uint64_t)cfg->periodUs * 1000);
+			clock_gettime(CLOCK_MONOTONIC, &next);
+		}
+	}
+	rtConfigOffline(&t->cfgDom, 0);
+	return NULL;
+}
+
+static int startThread(scnThread_t* t)
+{
+	struct sched_param my_params;
+	rtConfig_t initial;
+	pthread_attr_t attr;
+	cpu_set_t cpuSet;
+	int rc;
+
+	if (t->workload < WK_NUM_KERNELS &&
+			workloadInit(&t->wk, t->workload, t->workingSet, t->passes, 0)) {
+		printf("%s: could not allocate workload\n", t->name);
+		return -1;
+	}
+	initial.periodUs = t->periodUs;
+	initial.priority = t->priority;
+	initial.passes = t->passes;
+	if (rtConfigInit(&t->cfgDom, &initial, 1) != 0) {
+		return -1;
+	}
+	t->latSamples = calloc(MAX_LAT_SAMPLES, sizeof(uint64_t));
+
+	pthread_attr_init(&attr);
+	pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setschedpolicy(&attr, t->policy);
+	my_params.sched_priority = (t->policy == SCHED_OTHER) ? 0 : t->priority;
+	pthread_attr_setschedparam(&attr, &my_params);
+	if (t->cpu >= 0) {
+		CPU_ZERO(&cpuSet);
+		CPU_SET(t->cpu, &cpuSet);
+		pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuSet);
+	}
+	rc = pthread_create(&t->tid, &attr, periodicTask, t);
+	if (rc != 0) {
+		// without CAP_SYS_NICE fall back to the default policy
+		printf("%s: could not start with RT policy, using defaults\n",
+				t->name);
+		pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+		rc = pthread_create(&t->tid, &attr, periodicTask, t);
+	}
+	pthread_attr_destroy(&attr);
+	return (rc == 0) ? 0 : -1;
+}
+
+// apply a command from rtConfigCtl to the thread it names
+static void applyCommand(const rtConfigCmd_t* cmd)
+{
+	rtConfig_t next;
+	int i;
+	for (i = 0; i < scn.numThreads; ++i) {
+		scnThread_t* t = &scn.threads[i];
+		if (strcmp(t->name, cmd->thread) != 0) {
+			continue;
+		}
+		// the control thread is the only writer, so current is stable here
+		next = *t->cfgDom.current;
+		if (cmd->periodUs != 0) {
+			next.periodUs = cmd->periodUs;
+		}
+		if (cmd->priority != 0) {
+			next.priority = cmd->priority;
+		}
+		if (cmd->passes != 0) {
+			next.passes = cmd->passes;
+		}
+		if (rtConfigPublish(&t->cfgDom, &next) != 0) {
+			printf("%s: reconfiguration refused, grace period pending\n",
+					t->name);
+			return;
+		}
+		printf("%s: config v%llu period %u usec priority %d passes %u\n",
+				t->name, (unsigned long long)t->cfgDom.current->version,
+				next.periodUs, next.priority, next.passes);
+		return;
+	}
+	printf("reconfiguration for unknown thread %s ignored\n", cmd->thread);
+}
+
+// run for the scenario duration, serving reconfiguration commands
+static void controlLoop(void)
+{
+	rtConfigCmd_t* shm = rtConfigCmdMap();
+	rtConfigCmd_t cmd;
+	uint32_t lastSeq = 0;
+	uint64_t endNs = nowNs() + (uint64_t)scn.durationSec * 1000000000ULL;
+	int i;
+
+	if (shm == NULL) {
+		printf("cannot map %s, live reconfiguration disabled\n",
+				RTCFG_SHM_NAME);
+		sleep(scn.durationSec);
+		return;
+	}
+	// ignore a command left over from an earlier run
+	lastSeq = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+	while (nowNs() < endNs) {
+		usleep(CONTROL_POLL_US);
+		if (rtConfigCmdPoll(shm, &lastSeq, &cmd)) {
+			applyCommand(&cmd);
+		}
+		for (i = 0; i < scn.numThreads; ++i) {
+			rtConfigReclaim(&scn.threads[i].cfgDom);
+		}
+	}
+	munmap(shm, sizeof(*shm));
+}
+
+// the period shown is the one last published, changed by rtConfigCtl
+static void reportThread(scnThread_t* t)
+{
+	printf("%-16s %8u %8llu %8.1f %8.1f %8.1f %8.1f %8.1f %6u\n", t->name,
+			t->cfgDom.current->periodUs, (unsigned long long)t->wakeup.count,
+			phaseHistPercentile(&t->wakeup, 50) / 1e3,
+			phaseHistPercentile(&t->wakeup, 99) / 1e3,
+			t->wakeup.maxNs / 1e3,
+			phaseHistPercentile(&t->exec, 50) / 1e3,
+			t->exec.maxNs / 1e3, t->overruns);
+}
+
+int main(int argc, char* argv[])
+{
+	int fdMem = -1;
+	int needGpio = 0;
+	int i;
+
+	if (argc != 2) {
+		printf("usage: %s scenarioFile\n", argv[0]);
+		return 1;
+	}
+	if (loadScenario(argv[1], &scn) != 0) {
+		return 1;
+	}
+
+	for (i = 0; i < scn.numThreads; ++i) {
+		needGpio |= (scn.threads[i].workload == WK_LED);
+	}
+	if (needGpio) {
+		printf("Attempting to map GPIO1 Base Register address...\n\n");
+		fdMem = open("/dev/mem", (O_RDWR | O_SYNC));
+		if (fdMem != -1) {
+			gpio1BaseAddrPtr = (volatile uint32_t*)mmap(NULL, PAGE_SIZE,
+					PROT_READ | PROT_WRITE, MAP_SHARED, fdMem, HPS_GPIO1_BASE);
+		}
+		if (fdMem == -1 || gpio1BaseAddrPtr == MAP_FAILED) {
+			printf("ERROR: cannot map GPIO1, led workloads do nothing\n");
+			gpio1BaseAddrPtr = NULL;
+		}
+		else {
+			gpio1Regs = gpio1Base(gpio1BaseAddrPtr);
+			gpio1DdrWrite(gpio1Regs, HPS_GPIO1_ALL_ON);
+		}
+	}
+	if (scn.flightPath[0] != '\0' &&
+			flightRecOpenFile(&flightRec, scn.flightPath, FR_DEF_ENTRIES, 0)) {
+		printf("flight recorder disabled\n");
+	}
+	if (scn.crashPath[0] != '\0' && crashDumpInit(scn.crashPath) == 0) {
+		for (i = 0; i < scn.numThreads; ++i) {
+			scnThread_t* t = &scn.threads[i];
+			snprintf(t->dumpNames[0], sizeof(t->dumpNames[0]), "%s.wakeup",
+					t->name);
+			snprintf(t->dumpNames[1], sizeof(t->dumpNames[1]), "%s.exec",
+					t->name);
+			crashDumpAddHist(t->dumpNames[0], &t->wakeup);
+			crashDumpAddHist(t->dumpNames[1], &t->exec);
+		}
+	}
+	if (scn.lockMemory) {
+		printf("\nlocking memory...\n\n");
+		mlockall(MCL_CURRENT | MCL_FUTURE);
+	}
+
+	printf("running %d threads for %u seconds...\n", scn.numThreads,
+			scn.durationSec);
+	for (i = 0; i < scn.numThreads; ++i) {
+		if (startThread(&scn.threads[i]) != 0) {
+			stopAll = 1;
+			scn.numThreads = i;
+			break;
+		}
+	}
+	if (!stopAll) {
+		controlLoop();
+	}
+	stopAll = 1;
+	for (i = 0; i < scn.numThreads; ++i) {
+		pthread_join(scn.threads[i].tid, NULL);
+	}
+	flightRecClose(&flightRec);
+
+	printf("\n%-16s %8s %8s %8s %8s %8s %8s %8s %6s\n", "thread", "period",
+			"releases", "wake p50", "wake p99", "wake max", "exec p50",
+			"exec max", "overrun");
+	printf("%-16s %8s %8s %8s %8s %8s %8s %8s %6s\n", "", "(usec)", "",
+			"(usec)", "(usec)", "(usec)", "(usec)", "(usec)", "");
+	for (i = 0; i < scn.numThreads; ++i) {
+		scnThread_t* t = &scn.threads[i];
+		reportThread(t);
+		if (scn.resultsName[0] != '\0' && t->numSamples > 0) {
+			const rtConfig_t* cfg = t->cfgDom.current;
+			char name[128], config[256];
+			snprintf(name, sizeof(name), "%s.%s", scn.resultsName, t->name);
+			// after a live change the samples span both configurations
+			if (cfg->version == 0) {
+				snprintf(config, sizeof(config), "scenario=%s period=%u "
+						"priority=%d passes=%u cpu=%d", argv[1], cfg->periodUs,
+						cfg->priority, cfg->passes, t->cpu);
+			}
+			else {
+				snprintf(config, sizeof(config), "scenario=%s period=%u "
+						"priority=%d passes=%u cpu=%d cfgVersion=%llu "
+						"startPeriod=%u startPriority=%d", argv[1],
+						cfg->periodUs, cfg->priority, cfg->passes, t->cpu,
+						(unsigned long long)cfg->version, t->periodUs,
+						t->priority);
+			}
+			benchResultWrite(name, config, t->latSamples, t->numSamples);
+		}
+		if (t->workload < WK_NUM_KERNELS) {
+			workloadFree(&t->wk);
+		}
+		rtConfigDestroy(&t->cfgDom);
+		free(t->latSamples);
+	}
+
+	if (gpio1BaseAddrPtr != NULL) {
+		gpio1DrClearBits(gpio1Regs, HPS_GPIO1_ALL_ON);
+		munmap((void*)gpio1BaseAddrPtr, PAGE_SIZE);
+	}
+	if (fdMem != -1) {
+		close(fdMem);
+	}
+	return 0;
+}
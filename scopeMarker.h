@@ -0,0 +1,191 @@
+/*****************************************************************************
+ *
+ * scopeMarker.h
+ *
+ * Scope marker instrumentation, drives a GPIO or FPGA PIO output bit high
+ * while a named code region executes so the region can be timed with a
+ * scope or logic analyzer.
+ *
+ * Each region is bound once to a register and bit.  The register keeps a
+ * shadow of its output value, so entering or leaving a region is an atomic
+ * update of the shadow followed by a store to the register, no read across
+ * the bridge and no lock.  Threads sharing a register (taskOne's LED1 and
+ * taskThree's markers share GPIO1 DR) can still reach the device out of
+ * order, so after its store a writer reloads the shadow and stores again
+ * if it moved, the last store to land always carries the latest shadow.
+ * A stale value can show for the length of one store, and a writer never
+ * waits on another thread, so a preempted thread cannot stall a SCHED_FIFO
+ * one.  The shadow is only right if every write to a marker register goes
+ * through it, other bits on the same register are driven with
+ * scopeMarkerRegSet and scopeMarkerRegClear.
+ *
+ * With SCOPE_MARKER_LOG defined every edge is also recorded with a
+ * CLOCK_MONOTONIC timestamp in a ring, which scopeMarkerDump prints for
+ * correlation with the captured waveform.  Without SCOPE_MARKERS defined
+ * SCOPE_ENTER and SCOPE_EXIT compile to nothing.
+ *
+ * 		scopeMarkerRegInit(&gpio1Markers, gpio1Dr addr, 32);
+ * 		scopeMarkerBind(0, "calcModAndMapBits", &gpio1Markers, LED0 mask);
+ * 		SCOPE_ENTER(0);  ...  SCOPE_EXIT(0);
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef SCOPE_MARKER_H
+#define SCOPE_MARKER_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "socRegMap.h"
+
+#define SCOPE_MAX_REGIONS		16
+#define SCOPE_LOG_SIZE			4096		// edges kept, power of two
+
+typedef struct {
+	volatile void* addr;		// mapped register address
+	int width;					// register width, 8 or 32 bits
+	uint32_t shadow;			// register value, updated atomically
+} scopeMarkerReg_t;
+
+typedef struct {
+	const char* name;
+	scopeMarkerReg_t* reg;		// register holding the marker bit
+	uint32_t mask;				// marker bit within the register
+} scopeRegion_t;
+
+typedef struct {
+	uint64_t ns;				// CLOCK_MONOTONIC time of the edge
+	uint16_t id;				// region id
+	uint16_t level;				// 1 on entry, 0 on exit
+} scopeEdge_t;
+
+static scopeRegion_t scopeRegions[SCOPE_MAX_REGIONS];
+#ifdef SCOPE_MARKER_LOG
+static scopeEdge_t scopeLog[SCOPE_LOG_SIZE];
+static uint32_t scopeLogIdx;
+#endif
+
+// store the shadow to the register, a single device write
+static inline void scopeMarkerStore(scopeMarkerReg_t* reg, uint32_t val)
+{
+	SOC_REG_BARRIER();
+	if (reg->width == 8) {
+		*(volatile uint8_t*)reg->addr = (uint8_t)val;
+	}
+	else {
+		*(volatile uint32_t*)reg->addr = val;
+	}
+}
+
+// store the shadow until no other writer changed it in between, whichever
+// writer stores last leaves the latest shadow in the register
+static inline void scopeMarkerPublish(scopeMarkerReg_t* reg, uint32_t val)
+{
+	uint32_t now;
+	for (;;) {
+		scopeMarkerStore(reg, val);
+		SOC_REG_BARRIER();
+		now = __atomic_load_n(&reg->shadow, __ATOMIC_ACQUIRE);
+		if (now == val) {
+			break;
+		}
+		val = now;
+	}
+}
+
+// take ownership of a register, the shadow starts from its current value
+static inline void scopeMarkerRegInit(scopeMarkerReg_t* reg,
+		volatile void* addr, int width)
+{
+	reg->addr = addr;
+	reg->width = width;
+	reg->shadow = (width == 8) ? *(volatile uint8_t*)addr :
+			*(volatile uint32_t*)addr;
+}
+
+// set or clear non-marker bits on a marker register through its shadow
+static inline void scopeMarkerRegSet(scopeMarkerReg_t* reg, uint32_t mask)
+{
+	scopeMarkerPublish(reg,
+			__atomic_or_fetch(&reg->shadow, mask, __ATOMIC_ACQ_REL));
+}
+
+static inline void scopeMarkerRegClear(scopeMarkerReg_t* reg, uint32_t mask)
+{
+	scopeMarkerPublish(reg,
+			__atomic_and_fetch(&reg->shadow, ~mask, __ATOMIC_ACQ_REL));
+}
+
+// bind region id to a marker bit, the bit is driven low
+static inline void scopeMarkerBind(int id, const char* name,
+		scopeMarkerReg_t* reg, uint32_t mask)
+{
+	scopeRegions[id].name = name;
+	scopeRegions[id].reg = reg;
+	scopeRegions[id].mask = mask;
+	scopeMarkerRegClear(reg, mask);
+}
+
+static inline void scopeMarkerEdge(int id, int level)
+{
+	scopeRegion_t* r = &scopeRegions[id];
+	if (level) {
+		scopeMarkerRegSet(r->reg, r->mask);
+	}
+	else {
+		scopeMarkerRegClear(r->reg, r->mask);
+	}
+#ifdef SCOPE_MARKER_LOG
+	{
+		struct timespec ts;
+		uint32_t idx = __atomic_fetch_add(&scopeLogIdx, 1, __ATOMIC_RELAXED);
+		scopeEdge_t* e = &scopeLog[idx & (SCOPE_LOG_SIZE - 1)];
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		e->ns = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+		e->id = (uint16_t)id;
+		e->level = (uint16_t)level;
+	}
+#endif
+}
+
+// print the logged edges oldest first, with the duration of each region
+static inline void scopeMarkerDump(FILE* out)
+{
+#ifdef SCOPE_MARKER_LOG
+	uint64_t entryNs[SCOPE_MAX_REGIONS] = { 0 };
+	uint32_t end = scopeLogIdx;
+	uint32_t i = (end > SCOPE_LOG_SIZE) ? end - SCOPE_LOG_SIZE : 0;
+	fprintf(out, "\nscope marker edges (%u logged):\n\n", end);
+	for (; i < end; ++i) {
+		scopeEdge_t* e = &scopeLog[i & (SCOPE_LOG_SIZE - 1)];
+		if (e->level) {
+			entryNs[e->id] = e->ns;
+			fprintf(out, "%llu.%09llu  %-20s  rise\n",
+					(unsigned long long)(e->ns / 1000000000ULL),
+					(unsigned long long)(e->ns % 1000000000ULL),
+					scopeRegions[e->id].name);
+		}
+		else {
+			fprintf(out, "%llu.%09llu  %-20s  fall  %llu nsec\n",
+					(unsigned long long)(e->ns / 1000000000ULL),
+					(unsigned long long)(e->ns % 1000000000ULL),
+					scopeRegions[e->id].name, entryNs[e->id] ?
+					(unsigned long long)(e->ns - entryNs[e->id]) : 0ULL);
+		}
+	}
+#else
+	(void)out;
+#endif
+}
+
+#ifdef SCOPE_MARKERS
+#define SCOPE_ENTER(id)			scopeMarkerEdge((id), 1)
+#define SCOPE_EXIT(id)			scopeMarkerEdge((id), 0)
+#else
+#define SCOPE_ENTER(id)			do { } while (0)
+#define SCOPE_EXIT(id)			do { } while (0)
+#endif
+
+#endif // SCOPE_MARKER_H
@@ -0,0 +1,239 @@
+/*****************************************************************************
+ *
+ * socRegMap.h
+ *
+ * Register map for the HPS GPIO, FPGA PIO and FPGA on-chip RAM peripherals
+ * used by the pthreads hardware mapping programs.
+ *
+ * Each register is declared once with its region, width, byte offset from
+ * the base of its mmap'd region and its access mode.  The SOC_REG_* macros
+ * generate static inline accessors at compile time, so every access is a
+ * single volatile load or store of the declared width with the offset
+ * folded into the addressing mode.  Read-only registers get no write
+ * accessor and write-only registers get no read accessor, so a wrong-mode
+ * access fails to compile, and a misaligned offset is rejected by a static
+ * assertion.  Every region has its own base handle type, e.g. gpio1Base_t
+ * made with gpio1Base(ptr) from the mmap'd pointer, and the accessors of a
+ * region only accept that type, so passing the FPGA PIO mapping to a GPIO1
+ * accessor fails to compile as well.
+ *
+ * Generated names follow the register name, e.g. for gpio1Dr:
+ *
+ * 		gpio1DrRead(base)			volatile load
+ * 		gpio1DrWrite(base, val)		volatile store
+ * 		gpio1DrSetBits(base, mask)	read-modify-write, set bits
+ * 		gpio1DrClearBits(base, mask)	read-modify-write, clear bits
+ *
+ * Bit fields add <field>Get(base) and <field>Set(base, val), and RAM
+ * regions add <region>ReadAt(base, idx) and <region>WriteAt(base, idx, val),
+ * whose index is checked against the region's word count with assert, so
+ * the check is compiled out with NDEBUG.
+ *
+ * Define SOC_REG_NO_BARRIER to drop the memory barriers, e.g. when
+ * benchmarking the cost of the barrier itself.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef SOC_REG_MAP_H
+#define SOC_REG_MAP_H
+
+#include <stdint.h>
+#include <assert.h>
+
+// HPS GPIO1 addresses and bit settings
+#define HPS_GPIO1_BASE 			0xFF709000	// base register address HPS GPIO1
+#define HPS_GPIO1_DR_OFF_BYT	0x00		// byte offset to DR reg address
+#define	HPS_GPIO1_DDR_OFF_BYT	0x04		// byte offset to DDR reg address
+#define HPS_GPIO1_LED0 			0x01000000	// word write value HPS LED0
+#define HPS_GPIO1_LED1 			0x02000000	// word write value HPS LED1
+#define HPS_GPIO1_LED2 			0x04000000	// word write value HPS LED2
+#define HPS_GPIO1_LED3 			0x08000000	// word write value HPS LED3
+#define HPS_GPIO1_ALL_ON		0x0F000000
+#define	HPS_GPIO1_ALL_OFF		0x00000000
+
+// HPS GPIO2 addresses and bit settings
+#define HPS_GPIO2_BASE 			0xFF70A000	// base register address HPS GPIO2
+#define HPS_GPIO2_EXT_OFFSET	0x50		// byte offset to EXT port reg
+#define	HPS_GPIO2_DDR_OFF_BYT	0x04		// byte offset to DDR reg address
+#define HPS_GPIO2_KEY0 			0x00200000	// word read value HPS button 0
+#define HPS_GPIO2_KEY1 			0x00400000	// word read value HPS button 1
+#define HPS_GPIO2_KEY2 			0x00800000	// word read value HPS button 2
+#define HPS_GPIO2_KEY3 			0x01000000	// word read value HPS button 3
+#define	HPS_GPIO2_ALL_OFF		0x00000000
+
+// FPGA PIO addresses and bit settings
+#define HPS_FPGA_SLAVE_BASE		0xFF200000	// base register address LW bridge
+#define FPGA_PIO_LED_OFFSET		0x00010040	// byte offset to LED reg address
+#define FPGA_PIO_LED0 			0x01		// byte write value to FPGA LED0
+#define FPGA_PIO_LED1 			0x02		// byte write value to FPGA LED1
+#define FPGA_PIO_LED2 			0x04		// byte write value to FPGA LED2
+#define FPGA_PIO_LED3 			0x08		// byte write value to FPGA LED3
+#define FPGA_PIO_LED_ALL_ON		0x0F
+#define FPGA_PIO_LED_ALL_OFF	0x00
+#define FPGA_PIO_KEY_OFFSET		0x000100C0	// byte offset to button reg addr
+#define FPGA_PIO_KEY0 			0x01		// byte read value FPGA button 0
+#define FPGA_PIO_KEY1 			0x02		// byte read value FPGA button 1
+#define FPGA_PIO_KEY2 			0x04		// byte read value FPGA button 2
+#define FPGA_PIO_KEY3 			0x08		// byte read value FPGA button 3
+
+// FPGA on-chip RAM addresses, the array and buffer offsets are word aligned
+// so that 32 bit accesses across the bridge are never split
+#define HPS_FPGA_MEM_BASE		0xC0000000	// base register address FPGA RAM
+#define HPS_FPGA_MEM_SIZE		0x40000000	// FPGA RAM size in bytes
+#define FPGA_PIO_RAM_OFFSET		0x000		// byte offset to on-chip memory
+#define FPGA_PIO_ARR_OFFSET		0x010		// byte offset to storage array
+#define FPGA_PIO_ARR_WORDS		0x200		// words in the storage array
+#define FPGA_PIO_BUF_OFFSET		0x810		// byte offset to storage buffer
+#define FPGA_PIO_BUF_WORDS		0x200		// words in the storage buffer
+#define FPGA_FLIGHT_OFFSET		0x2000		// byte offset to flight recorder
+#define FPGA_FLIGHT_BYTES		0x8040		// header and 2048 events
+
+// memory barriers placed around device accesses, a dmb on ARM orders the
+// device access against normal memory, x86 only needs a compiler barrier
+#if defined(SOC_REG_NO_BARRIER)
+#define SOC_REG_BARRIER()		do { } while (0)
+#elif defined(__aarch64__)
+#define SOC_REG_BARRIER()		__asm__ __volatile__("dmb sy" ::: "memory")
+#elif defined(__arm__)
+#define SOC_REG_BARRIER()		__asm__ __volatile__("dmb" ::: "memory")
+#else
+#define SOC_REG_BARRIER()		__asm__ __volatile__("" ::: "memory")
+#endif
+
+// address of a register of the given width at a byte offset from base
+#define SOC_REG_ADDR(base, width, offset) \
+	((volatile uint##width##_t*)((volatile uint8_t*)(base) + (offset)))
+
+// base handle of one mmap'd region, a distinct type per region
+#define SOC_REGION_BASE(region) \
+typedef struct { volatile uint8_t* p; } region##Base_t; \
+static inline region##Base_t region##Base(volatile void* p) \
+{ \
+	region##Base_t base = { (volatile uint8_t*)p }; \
+	return base; \
+}
+
+#define SOC_REG_CHECK(name, width, offset) \
+	_Static_assert(((offset) % ((width) / 8)) == 0, \
+			#name " offset is not aligned to its width");
+
+#define SOC_REG_READER(region, name, width, offset) \
+static inline uint##width##_t name##Read(region##Base_t base) \
+{ \
+	uint##width##_t val = *SOC_REG_ADDR(base.p, width, offset); \
+	SOC_REG_BARRIER(); \
+	return val; \
+}
+
+#define SOC_REG_WRITER(region, name, width, offset) \
+static inline void name##Write(region##Base_t base, uint##width##_t val) \
+{ \
+	SOC_REG_BARRIER(); \
+	*SOC_REG_ADDR(base.p, width, offset) = val; \
+}
+
+// read-only register
+#define SOC_REG_RO(region, name, width, offset) \
+	SOC_REG_CHECK(name, width, offset) \
+	SOC_REG_READER(region, name, width, offset)
+
+// write-only register
+#define SOC_REG_WO(region, name, width, offset) \
+	SOC_REG_CHECK(name, width, offset) \
+	SOC_REG_WRITER(region, name, width, offset)
+
+// read-write register, also provides read-modify-write bit helpers
+#define SOC_REG_RW(region, name, width, offset) \
+	SOC_REG_CHECK(name, width, offset) \
+	SOC_REG_READER(region, name, width, offset) \
+	SOC_REG_WRITER(region, name, width, offset) \
+static inline void name##SetBits(region##Base_t base, uint##width##_t mask) \
+{ \
+	name##Write(base, name##Read(base) | mask); \
+} \
+static inline void name##ClearBits(region##Base_t base, \
+		uint##width##_t mask) \
+{ \
+	name##Write(base, name##Read(base) & (uint##width##_t)~mask); \
+}
+
+// bit field of a previously declared register, Set is only usable on
+// read-write registers because it needs both accessors
+#define SOC_FIELD(region, name, reg, width, shift, bits) \
+static inline uint##width##_t name##Get(region##Base_t base) \
+{ \
+	return (uint##width##_t)((reg##Read(base) >> (shift)) & \
+			((1ULL << (bits)) - 1)); \
+} \
+static inline void name##Set(region##Base_t base, uint##width##_t val) \
+{ \
+	uint##width##_t mask = (uint##width##_t)(((1ULL << (bits)) - 1) << (shift)); \
+	reg##Write(base, (reg##Read(base) & (uint##width##_t)~mask) | \
+			((uint##width##_t)(val << (shift)) & mask)); \
+}
+
+// array of same-width words in device memory, e.g. an on-chip RAM region
+#define SOC_REGION_RW(region, name, width, offset, count) \
+	SOC_REG_CHECK(name, width, offset) \
+enum { name##Count = (count) }; \
+static inline uint##width##_t name##ReadAt(region##Base_t base, \
+		uint32_t idx) \
+{ \
+	uint##width##_t val; \
+	assert(idx < name##Count); \
+	val = SOC_REG_ADDR(base.p, width, offset)[idx]; \
+	SOC_REG_BARRIER(); \
+	return val; \
+} \
+static inline void name##WriteAt(region##Base_t base, uint32_t idx, \
+		uint##width##_t val) \
+{ \
+	assert(idx < name##Count); \
+	SOC_REG_BARRIER(); \
+	SOC_REG_ADDR(base.p, width, offset)[idx] = val; \
+} \
+static inline volatile uint##width##_t* name##Ptr(region##Base_t base) \
+{ \
+	return SOC_REG_ADDR(base.p, width, offset); \
+}
+
+// GPIO1, base is the page mapped at HPS_GPIO1_BASE
+SOC_REGION_BASE(gpio1)
+SOC_REG_RW(gpio1, gpio1Dr, 32, HPS_GPIO1_DR_OFF_BYT)
+SOC_REG_RW(gpio1, gpio1Ddr, 32, HPS_GPIO1_DDR_OFF_BYT)
+SOC_FIELD(gpio1, gpio1Leds, gpio1Dr, 32, 24, 4)
+
+// GPIO2, base is the page mapped at HPS_GPIO2_BASE
+SOC_REGION_BASE(gpio2)
+SOC_REG_RW(gpio2, gpio2Ddr, 32, HPS_GPIO2_DDR_OFF_BYT)
+SOC_REG_RO(gpio2, gpio2Ext, 32, HPS_GPIO2_EXT_OFFSET)
+
+// FPGA PIO, base is the region mapped at HPS_FPGA_SLAVE_BASE
+SOC_REGION_BASE(fpgaPio)
+SOC_REG_RW(fpgaPio, fpgaPioLed, 8, FPGA_PIO_LED_OFFSET)
+SOC_FIELD(fpgaPio, fpgaPioLeds, fpgaPioLed, 8, 0, 4)
+SOC_REG_RO(fpgaPio, fpgaPioKey, 8, FPGA_PIO_KEY_OFFSET)
+
+// FPGA on-chip RAM, base is the region mapped at HPS_FPGA_MEM_BASE
+SOC_REGION_BASE(fpgaMem)
+SOC_REG_RW(fpgaMem, fpgaRamWord, 32, FPGA_PIO_RAM_OFFSET)
+SOC_REGION_RW(fpgaMem, fpgaRamArr, 32, FPGA_PIO_ARR_OFFSET,
+		FPGA_PIO_ARR_WORDS)
+SOC_REGION_RW(fpgaMem, fpgaRamBuf, 32, FPGA_PIO_BUF_OFFSET,
+		FPGA_PIO_BUF_WORDS)
+
+// GPIO2 keys are active low, returns non-zero while the key is pressed
+static inline int gpio2KeyPressed(gpio2Base_t base, uint32_t keyMask)
+{
+	return (gpio2ExtRead(base) & keyMask) == 0;
+}
+
+// FPGA PIO keys are active low, returns non-zero while the key is pressed
+static inline int fpgaPioKeyPressed(fpgaPioBase_t base, uint8_t keyMask)
+{
+	return (fpgaPioKeyRead(base) & keyMask) == 0;
+}
+
+#endif // SOC_REG_MAP_H
@@ -0,0 +1,138 @@
+/*****************************************************************************
+ *
+ * uioEvent.h
+ *
+ * Interrupt driven wakeups for FPGA events through a UIO device
+ * (/dev/uioN, e.g. bound with uio_pdrv_genirq to the FPGA interrupt).
+ *
+ * A UIO read blocks until the interrupt fires and returns the total
+ * interrupt count as a 32 bit value, writing a 32 bit 1 re-enables the
+ * interrupt line after the handler in the kernel masked it.  Drivers
+ * without an irqcontrol hook never mask the line and reject that write
+ * with ENOSYS (or EINVAL), such devices are used without re-arming.
+ *
+ * Hosts without the FPGA use an eventfd as a stand-in, opened by passing
+ * UIO_EVENT_SIM as the device path.  uioEventTrigger then plays the part of
+ * the FPGA raising its interrupt, so the same wait and re-arm code path can
+ * be exercised and timed anywhere.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef UIO_EVENT_H
+#define UIO_EVENT_H
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/eventfd.h>
+
+#define UIO_EVENT_SIM			"sim"	// device path selecting the stand-in
+
+typedef struct {
+	int fd;						// UIO device or eventfd descriptor
+	int isSim;					// non-zero when backed by an eventfd
+	int noRearm;				// driver has no irqcontrol, nothing to unmask
+	uint32_t count;				// interrupt count seen at the last wait
+	uint32_t missed;			// interrupts that fired between two waits
+} uioEvent_t;
+
+// re-enable the interrupt after it has been serviced
+static inline int uioEventRearm(uioEvent_t* ev)
+{
+	uint32_t enable = 1;
+	if (ev->isSim || ev->noRearm) {
+		return 0;
+	}
+	return (write(ev->fd, &enable, sizeof(enable)) == sizeof(enable)) ? 0 : -1;
+}
+
+// open the UIO device at devPath, or the eventfd stand-in when devPath is
+// UIO_EVENT_SIM, and arm the interrupt, returns -1 on failure
+static inline int uioEventOpen(uioEvent_t* ev, const char* devPath)
+{
+	memset(ev, 0, sizeof(*ev));
+	ev->isSim = (strcmp(devPath, UIO_EVENT_SIM) == 0);
+	if (ev->isSim) {
+		ev->fd = eventfd(0, EFD_CLOEXEC);
+	}
+	else {
+		ev->fd = open(devPath, O_RDWR | O_CLOEXEC);
+	}
+	if (ev->fd == -1) {
+		printf("uio: cannot open %s: %s\n", devPath, strerror(errno));
+		return -1;
+	}
+	// the irq may start masked, unmask it so the first event is delivered
+	if (uioEventRearm(ev) == -1) {
+		if (errno == ENOSYS || errno == EINVAL) {
+			// no irqcontrol in the driver, the line is never masked
+			ev->noRearm = 1;
+			return 0;
+		}
+		printf("uio: cannot enable the interrupt of %s: %s\n", devPath,
+				strerror(errno));
+		close(ev->fd);
+		ev->fd = -1;
+		return -1;
+	}
+	return 0;
+}
+
+// block until the interrupt fires or timeoutMs expires (-1 waits forever),
+// re-arms the interrupt before returning, returns 1 on an event, 0 on
+// timeout and -1 on failure
+static inline int uioEventWait(uioEvent_t* ev, int timeoutMs)
+{
+	struct pollfd pfd;
+	uint32_t count;
+	uint64_t simCount;
+	int rc;
+
+	pfd.fd = ev->fd;
+	pfd.events = POLLIN;
+	rc = poll(&pfd, 1, timeoutMs);
+	if (rc <= 0) {
+		return rc;
+	}
+	if (ev->isSim) {
+		// the eventfd counter resets on read, accumulate it like UIO does
+		if (read(ev->fd, &simCount, sizeof(simCount)) != sizeof(simCount)) {
+			return -1;
+		}
+		count = ev->count + (uint32_t)simCount;
+	}
+	else if (read(ev->fd, &count, sizeof(count)) != sizeof(count)) {
+		return -1;
+	}
+	if (ev->count != 0 && count - ev->count > 1) {
+		ev->missed += count - ev->count - 1;
+	}
+	ev->count = count;
+	return (uioEventRearm(ev) == 0) ? 1 : -1;
+}
+
+// software trigger for the stand-in, acts as the FPGA raising the interrupt
+static inline int uioEventTrigger(uioEvent_t* ev)
+{
+	uint64_t one = 1;
+	if (!ev->isSim) {
+		return -1;
+	}
+	return (write(ev->fd, &one, sizeof(one)) == sizeof(one)) ? 0 : -1;
+}
+
+static inline void uioEventClose(uioEvent_t* ev)
+{
+	if (ev->fd != -1) {
+		close(ev->fd);
+		ev->fd = -1;
+	}
+}
+
+#endif // UIO_EVENT_H
@@ -0,0 +1,186 @@
+/*****************************************************************************
+ *
+ * uioLatencyTest.c
+ *
+ * Measures interrupt to userspace wakeup latency through uioEvent.h.
+ *
+ * With the stand-in (device path "sim") a trigger thread records a
+ * CLOCK_MONOTONIC timestamp and raises the software interrupt, and the
+ * waiting thread, running SCHED_FIFO with locked memory like taskThree,
+ * measures how long it took to wake up.  With a real UIO device the FPGA
+ * raises the interrupt, so the test reports the interval between wakeups
+ * and its deviation from the expected event period instead.
+ *
+ * 		uioLatencyTest [device] [events] [periodUs]
+ *
+ * 		uioLatencyTest sim 10000 1000
+ * 		uioLatencyTest /dev/uio0 1000 100000
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "uioEvent.h"
+#include "benchResults.h"
+
+#define MY_RT_PRIORITY 			99 			// Highest possible priority
+#define WAIT_CPU				1			// cpu used by the waiting thread
+#define DEF_EVENTS				1000
+#define DEF_PERIOD_US			1000
+#define WAIT_TIMEOUT_PERIODS	10			// missed periods before giving up
+#define WAIT_TIMEOUT_MIN_MS		100			// floor for very short periods
+
+uioEvent_t uioEv;
+int numEvents = DEF_EVENTS;
+int periodUs = DEF_PERIOD_US;
+
+// trigger time of the pending software interrupt, written by the trigger
+// thread before the interrupt is raised
+volatile uint64_t triggerNs;
+
+uint64_t* latencies;
+int latencyCnt = 0;
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int compareU64(const void* a, const void* b)
+{
+	uint64_t x = *(const uint64_t*)a;
+	uint64_t y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+// raise one software interrupt per period
+void* triggerTask(void* arg)
+{
+	int i;
+	(void)arg;
+	for (i = 0; i < numEvents; ++i) {
+		usleep(periodUs);
+		triggerNs = nowNs();
+		__sync_synchronize();
+		uioEventTrigger(&uioEv);
+	}
+	return NULL;
+}
+
+// wait for interrupts at RT priority on the isolated cpu
+void* waitTask(void* arg)
+{
+	struct sched_param my_params;
+	cpu_set_t cpuSet;
+	uint64_t wakeNs, lastNs = 0;
+	int timeoutMs;
+	int rc;
+	(void)arg;
+
+	// give up after WAIT_TIMEOUT_PERIODS periods without an interrupt
+	timeoutMs = (int)(((int64_t)periodUs * WAIT_TIMEOUT_PERIODS + 999) / 1000);
+	if (timeoutMs < WAIT_TIMEOUT_MIN_MS) {
+		timeoutMs = WAIT_TIMEOUT_MIN_MS;
+	}
+
+	CPU_ZERO(&cpuSet);
+	CPU_SET(WAIT_CPU, &cpuSet);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+			&cpuSet) != 0) {
+		printf("could not set processor affinity...\n");
+	}
+	my_params.sched_priority = MY_RT_PRIORITY;
+	if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &my_params) != 0) {
+		printf("could not change scheduler policy\n");
+	}
+
+	while (latencyCnt < numEvents) {
+		rc = uioEventWait(&uioEv, timeoutMs);
+		if (rc != 1) {
+			printf("\nno interrupt received, stopping...\n");
+			break;
+		}
+		wakeNs = nowNs();
+		if (uioEv.isSim) {
+			latencies[latencyCnt++] = wakeNs - triggerNs;
+		}
+		else {
+			// deviation of the wakeup interval from the expected period
+			if (lastNs != 0) {
+				int64_t dev = (int64_t)(wakeNs - lastNs) -
+						(int64_t)periodUs * 1000;
+				latencies[latencyCnt++] = (dev < 0) ? -dev : dev;
+			}
+			lastNs = wakeNs;
+		}
+	}
+	return NULL;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* devPath = (argc > 1) ? argv[1] : UIO_EVENT_SIM;
+	pthread_t waitVar, triggerVar;
+	if (argc > 2) {
+		numEvents = atoi(argv[2]);
+	}
+	if (argc > 3) {
+		periodUs = atoi(argv[3]);
+	}
+	if (numEvents <= 0 || periodUs <= 0) {
+		printf("usage: %s [device|sim] [events] [periodUs]\n", argv[0]);
+		return 1;
+	}
+
+	latencies = calloc(numEvents, sizeof(uint64_t));
+	if (latencies == NULL || uioEventOpen(&uioEv, devPath) == -1) {
+		return 1;
+	}
+	printf("\nlocking memory...\n\n");
+	mlockall(MCL_CURRENT | MCL_FUTURE);
+
+	pthread_create(&waitVar, NULL, waitTask, NULL);
+	if (uioEv.isSim) {
+		pthread_create(&triggerVar, NULL, triggerTask, NULL);
+		pthread_join(triggerVar, NULL);
+	}
+	pthread_join(waitVar, NULL);
+
+	if (latencyCnt > 0) {
+		uint64_t sum = 0;
+		int i;
+		for (i = 0; i < latencyCnt; ++i) {
+			sum += latencies[i];
+		}
+		char config[128];
+		snprintf(config, sizeof(config), "device=%s periodUs=%d", devPath,
+				periodUs);
+		benchResultWrite(uioEv.isSim ? "uioLatency" : "uioInterval", config,
+				latencies, latencyCnt);
+		qsort(latencies, latencyCnt, sizeof(uint64_t), compareU64);
+		printf("%s, %d events, %u missed\n",
+				uioEv.isSim ? "interrupt to userspace latency" :
+				"wakeup interval deviation", latencyCnt, uioEv.missed);
+		printf("min %llu, avg %llu, p50 %llu, p99 %llu, max %llu (nsec)\n",
+				(unsigned long long)latencies[0],
+				(unsigned long long)(sum / latencyCnt),
+				(unsigned long long)latencies[latencyCnt / 2],
+				(unsigned long long)latencies[(latencyCnt * 99) / 100],
+				(unsigned long long)latencies[latencyCnt - 1]);
+	}
+
+	uioEventClose(&uioEv);
+	free(latencies);
+	return 0;
+}
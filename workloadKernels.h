@@ -0,0 +1,216 @@
+/*****************************************************************************
+ *
+ * workloadKernels.h
+ *
+ * Synthetic workload kernels used to model how different kinds of real
+ * work respond to scheduling policy, priority and memory locking.
+ *
+ * 		memset		store bandwidth over the working set
+ * 		triad		stream triad, a[i] = b[i] + s * c[i]
+ * 		random		dependent random loads across the working set
+ * 		int			integer multiply/xor/shift chain, no memory traffic
+ * 		fp			double precision multiply-add chain
+ * 		branchy		data dependent, unpredictable branches
+ * 		syscall		getppid() system calls, kernel entry and exit
+ *
+ * Each run does a fixed number of passes over the working set, or keeps
+ * repeating passes until durationUs has elapsed when that is non-zero.
+ * Every kernel folds its result into workloadSink, a volatile, so the
+ * compiler cannot vectorize away or delete the work.
+ *
+ * Created Date:  10/17/2026
+ *
+ ****************************************************************************/
+
+#ifndef WORKLOAD_KERNELS_H
+#define WORKLOAD_KERNELS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+
+typedef enum {
+	WK_MEMSET, WK_TRIAD, WK_RANDOM, WK_INT, WK_FP, WK_BRANCHY, WK_SYSCALL,
+	WK_NUM_KERNELS
+} workloadKind_t;
+
+typedef struct {
+	workloadKind_t kind;
+	size_t workingSetBytes;		// bytes touched per pass
+	uint32_t passes;			// passes per run when durationUs is zero
+	uint32_t durationUs;		// minimum run time, zero to use passes
+	uint8_t* buf;				// working set, split in three for triad
+	uint32_t* chain;			// random access permutation
+	size_t elems;				// 32 bit elements in chain
+} workload_t;
+
+static const char* workloadNames[WK_NUM_KERNELS] = {
+	"memset", "triad", "random", "int", "fp", "branchy", "syscall"
+};
+
+// results of every pass land here so the work cannot be optimized out
+static volatile uint64_t workloadSink;
+
+static inline int workloadLookup(const char* name)
+{
+	int k;
+	for (k = 0; k < WK_NUM_KERNELS; ++k) {
+		if (strcmp(name, workloadNames[k]) == 0) {
+			return k;
+		}
+	}
+	return -1;
+}
+
+// allocate the working set without touching it, so the first pass takes
+// the page faults, only the memset kernel can run on untouched memory,
+// returns -1 on failure
+static inline int workloadAlloc(workload_t* wk, workloadKind_t kind,
+		size_t workingSetBytes, uint32_t passes, uint32_t durationUs)
+{
+	memset(wk, 0, sizeof(*wk));
+	wk->kind = kind;
+	wk->workingSetBytes = (workingSetBytes < 64) ? 64 : workingSetBytes;
+	wk->passes = passes ? passes : 1;
+	wk->durationUs = durationUs;
+	wk->buf = malloc(wk->workingSetBytes);
+	return (wk->buf == NULL) ? -1 : 0;
+}
+
+// allocate and touch the working set, returns -1 on failure
+static inline int workloadInit(workload_t* wk, workloadKind_t kind,
+		size_t workingSetBytes, uint32_t passes, uint32_t durationUs)
+{
+	size_t i, j;
+	uint32_t tmp;
+
+	if (workloadAlloc(wk, kind, workingSetBytes, passes, durationUs) != 0) {
+		return -1;
+	}
+	memset(wk->buf, 1, wk->workingSetBytes);
+
+	if (kind == WK_RANDOM) {
+		// single cycle permutation, each load depends on the previous one
+		wk->elems = wk->workingSetBytes / sizeof(uint32_t);
+		wk->chain = (uint32_t*)wk->buf;
+		for (i = 0; i < wk->elems; ++i) {
+			wk->chain[i] = (uint32_t)i;
+		}
+		for (i = wk->elems - 1; i > 0; --i) {
+			j = (size_t)rand() % i;
+			tmp = wk->chain[i];
+			wk->chain[i] = wk->chain[j];
+			wk->chain[j] = tmp;
+		}
+	}
+	return 0;
+}
+
+static inline void workloadFree(workload_t* wk)
+{
+	free(wk->buf);
+	wk->buf = NULL;
+	wk->chain = NULL;
+}
+
+// one pass of the selected kernel over the working set
+static inline uint64_t workloadPass(workload_t* wk, uint64_t seed)
+{
+	size_t n = wk->workingSetBytes;
+	uint64_t acc = seed;
+	size_t i;
+
+	switch (wk->kind) {
+	case WK_MEMSET:
+		memset(wk->buf, (int)seed, n);
+		acc += wk->buf[seed % n];
+		break;
+	case WK_TRIAD: {
+		size_t len = n / (3 * sizeof(double));
+		double* a = (double*)wk->buf;
+		double* b = a + len;
+		double* c = b + len;
+		double s = 3.0 + (double)(seed & 7);
+		for (i = 0; i < len; ++i) {
+			a[i] = b[i] + s * c[i];
+		}
+		acc += (uint64_t)a[seed % (len ? len : 1)];
+		break;
+	}
+	case WK_RANDOM: {
+		uint32_t idx = (uint32_t)(seed % wk->elems);
+		for (i = 0; i < wk->elems; ++i) {
+			idx = wk->chain[idx];
+		}
+		acc += idx;
+		break;
+	}
+	case WK_INT:
+		// same operation count as one word per 4 bytes of working set
+		for (i = 0; i < n / 4; ++i) {
+			acc = (acc * 6364136223846793005ULL + 1442695040888963407ULL);
+			acc ^= acc >> 29;
+		}
+		break;
+	case WK_FP: {
+		double x = 1.0 + (double)(seed & 0xFF) * 1e-9;
+		for (i = 0; i < n / 8; ++i) {
+			x = x * 0.999999 + 1e-7;
+		}
+		acc += (uint64_t)(x * 1e6);
+		break;
+	}
+	case WK_BRANCHY: {
+		uint32_t lcg = (uint32_t)seed | 1;
+		for (i = 0; i < n; ++i) {
+			lcg = lcg * 1664525u + 1013904223u;
+			if (lcg & 0x80000000u) {
+				acc += wk->buf[i];
+			}
+			else if (lcg & 0x40000000u) {
+				acc ^= i;
+			}
+			else {
+				acc -= 3;
+			}
+		}
+		break;
+	}
+	case WK_SYSCALL:
+		// one system call per cache line of working set
+		for (i = 0; i < n / 64; ++i) {
+			acc += (uint64_t)getppid();
+		}
+		break;
+	default:
+		break;
+	}
+	return acc;
+}
+
+// run the workload, returns the elapsed time in nsec
+static inline uint64_t workloadRun(workload_t* wk)
+{
+	struct timespec ts;
+	uint64_t start, now, acc = 0;
+	uint32_t p = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	start = now = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+	do {
+		acc = workloadPass(wk, acc + p);
+		++p;
+		if (wk->durationUs != 0 || p == wk->passes) {
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			now = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+		}
+	} while (wk->durationUs != 0 ? (now - start < wk->durationUs * 1000ULL) :
+			(p < wk->passes));
+	workloadSink += acc;
+	return now - start;
+}
+
+#endif // WORKLOAD_KERNELS_H